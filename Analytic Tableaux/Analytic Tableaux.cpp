@@ -4,80 +4,465 @@
 #include "stdafx.h"
 #include "fol.hpp"
 #include "tableaux.h"
+#include "prover.h"
+#include "batch.h"
+#include "server.h"
+#include "tptp.h"
+#include "snapshot.h"
+#include "portfolio.h"
+#include "strategy.h"
+#include "selftest.h"
 
 #include <string>
 #include <fstream>
+#include <thread>
 
 using namespace std;
 
-extern int yyparse();
+void printUsage(const string & problem)
+{
+	cerr << problem << " The correct syntax for calling this program is:" << endl;
+	cerr << "\tAnalytic Tableaux.exe [--engine tableaux|instgen|resolution|auto] [--simplify] [--lookahead] [--models] [--timeout ms]" << endl;
+	cerr << "\t\t[--rules N] [--memory MB] [--certificate file]" << endl;
+	cerr << "\t\t[--relevance N [--tolerance X]] [--portfolio [strategies]]" << endl;
+	cerr << "\t\t[--batch [file] [--premises file] | --server socket | --tptp file] [--include dir] [--jobs N]" << endl;
+	cerr << "\tAnalytic Tableaux.exe --premises file [--include dir] --snapshot file" << endl;
+	cerr << "\tAnalytic Tableaux.exe --help" << endl;
+	cerr << "\tAnalytic Tableaux.exe --selftest" << endl;
+}
 
-/* Ovaj pokazivac ce nakon parsiranja dobiti vrednost
-adrese parsirane formule. */
-extern Formula parsed_formula;
+int showHelp()
+{
+	ifstream infile;
+	string fileloc[] = { ".\\help.txt", "..\\Analytic Tableaux\\help.txt", "./help.txt" };
+	string line;
 
-int main(int argc, char **argv)
+	cout << "Welcome to Analytic Tableaux HELP!" << endl << endl;
+
+	for (string & fileName : fileloc)
+	{
+		infile = ifstream(fileName.c_str());
+		if (infile.good())
+		{
+			break;
+		}
+	}
+
+	while (!infile.eof())
+	{
+		getline(infile, line);
+		cout << line << endl;
+	}
+	infile.close();
+	return 0;
+}
+
+// Writes which strategy of the portfolio decided, and what every strategy gave
+void printPortfolio(const PortfolioResult & portfolio, const string & linePrefix)
 {
-	// Check if the number of arguments is inaccurate
-	if (argc > 2)
+	if (portfolio.winner.empty())
 	{
-		cerr << "Too many arguments! The correct syntax for calling this program is:" << endl;
-		cerr << "\tAnalytic Tableaux.exe" << endl;
-		cerr << "\tAnalytic Tableaux.exe --help" << endl;
-		exit(EXIT_FAILURE);
+		cout << linePrefix << "No strategy decided in " << portfolio.milliseconds << " ms" << endl;
 	}
+	else
+	{
+		cout << linePrefix << "Decided by " << portfolio.winner << " in " << portfolio.milliseconds << " ms" << endl;
+	}
+	for (const PortfolioResult::Run & run : portfolio.runs)
+	{
+		cout << linePrefix << "\t" << run.name << "\t" << run.result << "\t" << run.milliseconds << endl;
+	}
+}
 
-	// Check if there is an additional argument "--help"
-	if (argc == 2)
+// Without a portfolio the problem is proved by the engine
+int proveTptp(const string & path, const string & includeDirectory, Engine engine, const TableauxOptions & options, const vector<PortfolioStrategy> * portfolio)
+{
+	TptpProblem problem;
+	string error;
+	if (!readTptpFile(path, includeDirectory, problem, error))
 	{
-		// If that argument is not "--help"
-		if (string(argv[1]) != "--help")
+		cerr << error << endl;
+		cout << "% SZS status Error for " << path << endl;
+		return EXIT_FAILURE;
+	}
+
+	// The tableaux of a whole problem is too large to be written
+	TableauxOptions tptpOptions = options;
+	tptpOptions.trace = false;
+
+	if (portfolio != nullptr)
+	{
+		PortfolioResult result = provePortfolio(Theory(problem.premises), getTptpConjecture(problem), *portfolio, options.timeLimit);
+		cout << "% SZS status " << getSzsStatus(result.result, problem) << " for " << path << endl;
+		printPortfolio(result, "% ");
+		return 0;
+	}
+
+	string result;
+	EngineReport report;
+	try
+	{
+		result = proveConjecture(Theory(problem.premises), getTptpConjecture(problem), engine, tptpOptions, &report);
+	}
+	catch (const char * message)
+	{
+		cerr << message << endl;
+		result = "ERROR";
+	}
+	cout << "% SZS status " << getSzsStatus(result, problem) << " for " << path << endl;
+	if (!report.counterModel.empty())
+	{
+		cout << "% SZS output start Model for " << path << endl;
+		cout << report.counterModel << endl;
+		cout << "% SZS output end Model for " << path << endl;
+	}
+	return 0;
+}
+
+// Reads the premises, from a snapshot if the file is one
+unique_ptr<Theory> readTheory(const string & path, const string & includeDirectory)
+{
+	string error;
+	if (isFormulaSnapshot(path))
+	{
+		FormulaSnapshot snapshot;
+		if (!snapshot.open(path, error))
 		{
-			cerr << "Unknown argument! The correct syntax for calling this program is:" << endl;
-			cerr << "\tAnalytic Tableaux.exe" << endl;
-			cerr << "\tAnalytic Tableaux.exe --help" << endl;
+			cerr << error << endl;
 			exit(EXIT_FAILURE);
 		}
-		// Otherwise, show the help
+
+		try
+		{
+			// The formulas of a snapshot are already prepared for the tableaux
+			return unique_ptr<Theory>(new Theory(snapshot.getFormulas(), true));
+		}
+		catch (const char * exception)
 		{
-			ifstream infile;
-			string fileloc[] = { ".\\help.txt", "..\\Analytic Tableaux\\help.txt", "./help.txt" };
-			string line;
+			cerr << exception << endl;
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	vector<Formula> formulas;
+	if (!readPremises(path, includeDirectory, formulas, error))
+	{
+		cerr << error << endl;
+		exit(EXIT_FAILURE);
+	}
+	return unique_ptr<Theory>(new Theory(formulas));
+}
+
+// Prepares the premises for the tableaux and writes them to a snapshot
+int writeSnapshot(const string & path, const string & includeDirectory, const string & snapshotPath)
+{
+	vector<Formula> formulas;
+	string error;
+	if (!readPremises(path, includeDirectory, formulas, error))
+	{
+		cerr << error << endl;
+		return EXIT_FAILURE;
+	}
+
+	for (Formula & f : formulas)
+	{
+		f = prepareForTableaux(f);
+	}
+
+	if (!writeFormulaSnapshot(snapshotPath, formulas, error))
+	{
+		cerr << error << endl;
+		return EXIT_FAILURE;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	TableauxOptions options;
+	Engine engine = E_TABLEAUX;
+	bool batch = false;
+	string batchFile;
+	string socketPath;
+	string tptpFile;
+	string premiseFile;
+	string snapshotFile;
+	string certificateFile;
+	// The TPTP library keeps the included axiom files under its root
+	const char * tptpRoot = getenv("TPTP");
+	string includeDirectory = tptpRoot != 0 ? tptpRoot : "";
+	unsigned jobs = 1;
+	bool usePortfolio = false;
+	vector<PortfolioStrategy> portfolio = getDefaultPortfolio();
 
-			cout << "Welcome to Analytic Tableaux HELP!" << endl << endl;
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg(argv[i]);
 
-			for (string & fileName : fileloc)
+		// The help is shown only if it is the only argument
+		if (arg == "--help" && argc == 2)
+		{
+			return showHelp();
+		}
+		else if (arg == "--selftest" && argc == 2)
+		{
+			unsigned failed = runSelfTests(cerr);
+			cout << (failed == 0 ? "All the self tests passed" : to_string(failed) + " self tests failed") << endl;
+			return failed == 0 ? 0 : EXIT_FAILURE;
+		}
+		else if (arg == "--simplify")
+		{
+			options.simplifyBranches = true;
+		}
+		else if (arg == "--lookahead")
+		{
+			options.betaSelection = TableauxOptions::BS_LOOKAHEAD;
+		}
+		else if (arg == "--models")
+		{
+			options.findModels = true;
+		}
+		else if (arg == "--engine" && i + 1 < argc)
+		{
+			if (!parseEngine(argv[++i], engine))
+			{
+				printUsage("Unknown engine!");
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if (arg == "--batch")
+		{
+			batch = true;
+			// The file is optional, the standard input is read without it
+			if (i + 1 < argc && (argv[i + 1][0] != '-' || string(argv[i + 1]) == "-"))
+			{
+				batchFile = argv[++i];
+			}
+		}
+		else if (arg == "--server" && i + 1 < argc)
+		{
+			socketPath = argv[++i];
+		}
+		else if (arg == "--tptp" && i + 1 < argc)
+		{
+			tptpFile = argv[++i];
+		}
+		else if (arg == "--premises" && i + 1 < argc)
+		{
+			premiseFile = argv[++i];
+		}
+		else if (arg == "--snapshot" && i + 1 < argc)
+		{
+			snapshotFile = argv[++i];
+		}
+		else if (arg == "--certificate" && i + 1 < argc)
+		{
+			certificateFile = argv[++i];
+		}
+		else if (arg == "--include" && i + 1 < argc)
+		{
+			includeDirectory = argv[++i];
+		}
+		else if (arg == "--timeout" && i + 1 < argc)
+		{
+			int n = atoi(argv[++i]);
+			if (n <= 0)
+			{
+				printUsage("Wrong timeout!");
+				exit(EXIT_FAILURE);
+			}
+			options.timeLimit = n;
+		}
+		else if (arg == "--portfolio")
+		{
+			usePortfolio = true;
+			// The strategies are optional, the default portfolio is raced without them
+			if (i + 1 < argc && argv[i + 1][0] != '-' && !parsePortfolio(argv[++i], portfolio))
+			{
+				printUsage("Wrong portfolio!");
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if (arg == "--relevance" && i + 1 < argc)
+		{
+			int n = atoi(argv[++i]);
+			if (n <= 0)
 			{
-				infile = ifstream(fileName.c_str());
-				if (infile.good())
-				{
-					break;
-				}
+				printUsage("Wrong relevance depth!");
+				exit(EXIT_FAILURE);
 			}
-			
-			while (!infile.eof())
+			options.relevanceDepth = n;
+		}
+		else if (arg == "--tolerance" && i + 1 < argc)
+		{
+			double x = atof(argv[++i]);
+			if (x < 1.0)
 			{
-				getline(infile, line);
-				cout << line << endl;
+				printUsage("Wrong tolerance!");
+				exit(EXIT_FAILURE);
 			}
-			infile.close();
-			return 0;
+			options.relevanceTolerance = x;
+		}
+		else if (arg == "--rules" && i + 1 < argc)
+		{
+			int n = atoi(argv[++i]);
+			if (n <= 0)
+			{
+				printUsage("Wrong rule limit!");
+				exit(EXIT_FAILURE);
+			}
+			options.ruleLimit = n;
+		}
+		else if (arg == "--memory" && i + 1 < argc)
+		{
+			int n = atoi(argv[++i]);
+			if (n <= 0)
+			{
+				printUsage("Wrong memory limit!");
+				exit(EXIT_FAILURE);
+			}
+			options.memoryLimit = (size_t)n * 1024 * 1024;
+		}
+		else if (arg == "--jobs" && i + 1 < argc)
+		{
+			int n = atoi(argv[++i]);
+			if (n < 0)
+			{
+				printUsage("Wrong number of jobs!");
+				exit(EXIT_FAILURE);
+			}
+			// With 0 jobs there is one for each hardware thread
+			jobs = n > 0 ? n : max(thread::hardware_concurrency(), 1u);
+		}
+		else
+		{
+			printUsage("Unknown argument!");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if ((batch ? 1 : 0) + (socketPath.empty() ? 0 : 1) + (tptpFile.empty() ? 0 : 1) > 1)
+	{
+		printUsage("The batch, the server and the TPTP mode cannot be used together!");
+		exit(EXIT_FAILURE);
+	}
+
+	if (jobs > 1 && !batch && socketPath.empty())
+	{
+		printUsage("The jobs can only be used in the batch or the server mode!");
+		exit(EXIT_FAILURE);
+	}
+
+	if (!snapshotFile.empty())
+	{
+		if (premiseFile.empty() || batch || !socketPath.empty() || !tptpFile.empty())
+		{
+			printUsage("The snapshot is written only from the premises!");
+			exit(EXIT_FAILURE);
+		}
+		return writeSnapshot(premiseFile, includeDirectory, snapshotFile);
+	}
+
+	if (usePortfolio && (batch || !socketPath.empty()))
+	{
+		printUsage("The portfolio can only be used for one formula or a TPTP problem!");
+		exit(EXIT_FAILURE);
+	}
+
+	ofstream certificate;
+	if (!certificateFile.empty())
+	{
+		if (batch || !socketPath.empty() || usePortfolio)
+		{
+			printUsage("The certificate is written only for one formula or a TPTP problem!");
+			exit(EXIT_FAILURE);
 		}
+		certificate.open(certificateFile, ios::binary);
+		if (!certificate)
+		{
+			printUsage("Cannot write the certificate file!");
+			exit(EXIT_FAILURE);
+		}
+		options.certificateOutput = &certificate;
+	}
+
+	if (!premiseFile.empty() && !batch)
+	{
+		printUsage("The premises can only be used in the batch mode!");
+		exit(EXIT_FAILURE);
+	}
+
+	if (!tptpFile.empty())
+	{
+		return proveTptp(tptpFile, includeDirectory, engine, options, usePortfolio ? &portfolio : nullptr);
+	}
+
+	if (!socketPath.empty())
+	{
+		return runServer(socketPath, engine, options, jobs);
+	}
+
+	if (batch)
+	{
+		// The premises are read and prepared once for all the formulas of the batch
+		unique_ptr<Theory> premises;
+		if (!premiseFile.empty())
+		{
+			premises = readTheory(premiseFile, includeDirectory);
+		}
+
+		if (batchFile.empty() || batchFile == "-")
+		{
+			proveBatch(cin, cout, engine, options, jobs, premises.get());
+		}
+		else if (!proveBatchFile(batchFile, cout, engine, options, jobs, premises.get()))
+		{
+			printUsage("Cannot open the batch file!");
+			exit(EXIT_FAILURE);
+		}
+		return 0;
 	}
 
 	cout << "Welcome to Analytic Tableaux!" << endl;
 	cout << "Please type in a first-order logic formula to generate its tableaux." << endl;
 	cout << "If you need help, run this program again with option --help." << endl << endl;
 
-	yyparse();
+	// The formula may span several lines, up to its ';'
+	string text;
+	string error;
+	getline(cin, text, ';');
+	Formula f = parseFormula(text, error);
 	cout << endl;
 
-	if (parsed_formula.get() != 0)
+	if (f.get() != 0 && usePortfolio)
 	{
-		Tableaux t(parsed_formula);
-		string result = t.getResult();
+		// The strategies run at once, so no tableaux is written
+		PortfolioResult result = provePortfolio(Theory(), f, portfolio, options.timeLimit);
+		cout << "Your formula is " << result.result << endl;
+		printPortfolio(result, "");
+	}
+	else if (f.get() != 0)
+	{
+		if (engine == E_AUTO)
+		{
+			PortfolioStrategy strategy = selectStrategy(Theory(), f, options);
+			cout << "The strategy is " << strategy.name << endl;
+			engine = strategy.engine;
+			options = strategy.options;
+		}
 
+		// The tableaux is written while the formula is being proved, before the result
+		EngineReport report;
+		string result = proveFormula(f, engine, options, &report);
 		cout << "Your formula is " << result << endl;
+		if (!report.counterModel.empty())
+		{
+			cout << "A counter-model is " << report.counterModel << endl;
+		}
+	}
+	else
+	{
+		cerr << error << endl;
 	}
 
 	getc(stdin);
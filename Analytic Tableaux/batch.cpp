@@ -0,0 +1,227 @@
+#include "stdafx.h"
+#include "batch.h"
+#include "mappedfile.h"
+#include "pratt.h"
+#include "threadpool.h"
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+
+/* One formula of the batch. Its result is filled in by a worker thread. */
+struct BatchJob
+{
+	Formula formula;
+	string result;
+	string error;
+	double milliseconds;
+	bool done;
+};
+
+/* Gives the next formula of the batch, or the error if it cannot be parsed.
+Returns false when there are no more formulas. */
+typedef function<bool(Formula &, string &)> FormulaSource;
+
+static bool isBlank(const string & s)
+{
+	return s.find_first_not_of(" \t\r\n") == string::npos;
+}
+
+/* Reads the next formula with its ';' from the input. Returns false
+when there are no more formulas. */
+static bool readFormula(istream & input, string & chunk)
+{
+	while (getline(input, chunk, ';'))
+	{
+		// A formula at the end of the input may come without its ';'
+		if (!isBlank(chunk))
+		{
+			chunk += ';';
+			return true;
+		}
+	}
+	return false;
+}
+
+static double getMilliseconds(chrono::steady_clock::time_point start)
+{
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+/* Takes the next formula from the source. Its parse time is counted in the
+time of the job, and a formula that cannot be parsed is done right away. */
+static bool readJob(const FormulaSource & source, BatchJob & job)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if (!source(job.formula, job.error))
+	{
+		return false;
+	}
+	job.milliseconds = getMilliseconds(start);
+	job.done = job.formula.get() == 0;
+	if (job.done)
+	{
+		job.result = "ERROR";
+	}
+	return true;
+}
+
+static void proveJob(BatchJob & job, const Theory & premises, Engine engine, const TableauxOptions & options)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	try
+	{
+		job.result = proveConjecture(premises, job.formula, engine, options);
+	}
+	catch (const char * message)
+	{
+		job.result = "ERROR";
+		job.error = message;
+	}
+	job.milliseconds += getMilliseconds(start);
+
+	// The formula is not needed any more
+	job.formula = Formula();
+}
+
+static void writeJob(const BatchJob & job, unsigned index, ostream & output)
+{
+	output << index << '\t' << job.result << '\t' << fixed << setprecision(3) << job.milliseconds;
+	if (!job.error.empty())
+	{
+		output << '\t' << job.error;
+	}
+	output << endl;
+}
+
+static void proveSequentially(const FormulaSource & source, ostream & output, const Theory & premises, Engine engine, const TableauxOptions & options)
+{
+	unsigned index = 0;
+	BatchJob job;
+
+	while (readJob(source, job))
+	{
+		if (!job.done)
+		{
+			proveJob(job, premises, engine, options);
+		}
+		writeJob(job, ++index, output);
+		job = BatchJob();
+	}
+}
+
+/* Writes the jobs at the front of the window that are done, in order, until
+only the given number of jobs is left in it. Waits for the jobs that are not
+done yet only while the window is longer than that. */
+static void writeDoneJobs(deque<shared_ptr<BatchJob>> & window, size_t keep, unsigned & index, ostream & output, mutex & doneMutex, condition_variable & doneCondition)
+{
+	while (!window.empty())
+	{
+		{
+			unique_lock<mutex> lock(doneMutex);
+			if (window.size() > keep)
+			{
+				doneCondition.wait(lock, [&window] { return window.front()->done; });
+			}
+			else if (!window.front()->done)
+			{
+				return;
+			}
+		}
+		writeJob(*window.front(), ++index, output);
+		window.pop_front();
+	}
+}
+
+static void proveInParallel(const FormulaSource & source, ostream & output, const Theory & premises, Engine engine, const TableauxOptions & options, unsigned jobs)
+{
+	// The formulas are read only a few jobs ahead of the results written,
+	// so that a batch of any length can be proved in a bounded memory
+	const size_t windowLength = jobs * 4;
+	deque<shared_ptr<BatchJob>> window;
+	unsigned index = 0;
+
+	mutex doneMutex;
+	condition_variable doneCondition;
+	ThreadPool pool(jobs);
+
+	while (true)
+	{
+		shared_ptr<BatchJob> job = make_shared<BatchJob>();
+		if (!readJob(source, *job))
+		{
+			break;
+		}
+		window.push_back(job);
+
+		if (!job->done)
+		{
+			pool.submit([job, &premises, engine, &options, &doneMutex, &doneCondition]
+			{
+				proveJob(*job, premises, engine, options);
+				{
+					lock_guard<mutex> lock(doneMutex);
+					job->done = true;
+				}
+				doneCondition.notify_all();
+			});
+		}
+
+		writeDoneJobs(window, windowLength - 1, index, output, doneMutex, doneCondition);
+	}
+
+	writeDoneJobs(window, 0, index, output, doneMutex, doneCondition);
+}
+
+static void proveFromSource(const FormulaSource & source, ostream & output, Engine engine, const TableauxOptions & options, unsigned jobs, const Theory * premises)
+{
+	TableauxOptions batchOptions = options;
+	batchOptions.trace = false;
+
+	// Without premises every formula is proved on its own
+	Theory noPremises;
+	const Theory & theory = premises != nullptr ? *premises : noPremises;
+
+	if (jobs > 1)
+	{
+		proveInParallel(source, output, theory, engine, batchOptions, jobs);
+	}
+	else
+	{
+		proveSequentially(source, output, theory, engine, batchOptions);
+	}
+}
+
+void proveBatch(istream & input, ostream & output, Engine engine, const TableauxOptions & options, unsigned jobs, const Theory * premises)
+{
+	string chunk;
+	FormulaSource source = [&input, &chunk](Formula & f, string & error)
+	{
+		if (!readFormula(input, chunk))
+		{
+			return false;
+		}
+		f = parseFormula(chunk, error);
+		return true;
+	};
+	proveFromSource(source, output, engine, options, jobs, premises);
+}
+
+bool proveBatchFile(const string & path, ostream & output, Engine engine, const TableauxOptions & options, unsigned jobs, const Theory * premises)
+{
+	MappedFile file;
+	if (!file.open(path))
+	{
+		return false;
+	}
+
+	PrattParser parser(file.getData(), file.getSize());
+	FormulaSource source = [&parser](Formula & f, string & error)
+	{
+		// A formula that cannot be parsed is skipped by the parser with the error set
+		return parser.parseNext(f, error) || !error.empty();
+	};
+	proveFromSource(source, output, engine, options, jobs, premises);
+	return true;
+}
@@ -0,0 +1,25 @@
+#ifndef _BATCH_H
+#define _BATCH_H
+
+#include <iostream>
+#include <string>
+
+#include "prover.h"
+
+/* Proves every formula of the input, one after another. Formulas are
+terminated by ';'. For each formula a single line is written to the output:
+its index, the result (TAUTOLOGY, NOT A TAUTOLOGY, UNKNOWN if a limit of
+the options was reached or the engine could not decide, or ERROR) and the
+time spent on it in milliseconds, separated by tabs. The tableaux are not traced.
+With more than one job the formulas are proved concurrently on that many
+threads, but the results are still written in the input order. If the
+premises are given, every formula is a conjecture proved from them. */
+void proveBatch(istream & input, ostream & output, Engine engine, const TableauxOptions & options, unsigned jobs = 1, const Theory * premises = nullptr);
+
+/* Proves every formula of the file like proveBatch, but maps the file into
+memory and parses it in place, so that it is never read whole. Only a few
+formulas per job are held at any time, so files of any size can be proved.
+Returns false if the file cannot be opened. */
+bool proveBatchFile(const string & path, ostream & output, Engine engine, const TableauxOptions & options, unsigned jobs = 1, const Theory * premises = nullptr);
+
+#endif // _BATCH_H
@@ -0,0 +1,46 @@
+#include "stdafx.h"
+#include "cancellation.h"
+
+// ----------------------------------------------------------------------------
+// CancellationToken
+
+CancellationToken::CancellationToken()
+{}
+
+CancellationToken CancellationToken::create()
+{
+	return create(CancellationToken());
+}
+
+CancellationToken CancellationToken::create(const CancellationToken & parent)
+{
+	CancellationToken token;
+	token._state = make_shared<State>();
+	token._state->cancelled.store(false);
+	token._state->parent = parent._state;
+	return token;
+}
+
+void CancellationToken::cancel() const
+{
+	if (_state != nullptr)
+	{
+		_state->cancelled.store(true);
+	}
+}
+
+bool CancellationToken::isCancelled() const
+{
+	// The flags only guard whether to go on, so they need no ordering with other memory
+	for (const State * state = _state.get(); state != nullptr; state = state->parent.get())
+	{
+		if (state->cancelled.load(memory_order_relaxed))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// END CancellationToken
+// ----------------------------------------------------------------------------
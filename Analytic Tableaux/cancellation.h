@@ -0,0 +1,39 @@
+#ifndef _CANCELLATION_H
+#define _CANCELLATION_H
+
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+/* Lets another thread ask a running proof to give up. The copies of a token
+share its flag, so the one who starts a proof keeps a copy and cancels it,
+and the proof polls its own copy where it checks its time limit. The proof
+then unwinds as when it runs out of time, and gives UNKNOWN. A token made
+by the default constructor is never cancelled and costs nothing to poll. */
+class CancellationToken
+{
+private:
+	struct State
+	{
+		atomic<bool> cancelled;
+		// A token made from another one is cancelled with it as well
+		shared_ptr<const State> parent;
+	};
+
+	shared_ptr<State> _state;
+public:
+	CancellationToken();
+
+	// Makes a token which can be cancelled
+	static CancellationToken create();
+	/* Makes a token which is cancelled on its own or when the parent is, so
+	that a part of a proof can be stopped without stopping the rest. */
+	static CancellationToken create(const CancellationToken & parent);
+
+	// Does nothing to a token made by the default constructor
+	void cancel() const;
+	bool isCancelled() const;
+};
+
+#endif // _CANCELLATION_H
@@ -0,0 +1,133 @@
+#include "stdafx.h"
+#include "certificate.h"
+
+#include <sstream>
+
+// The buffer is written to the stream when it grows past this many bytes
+static const size_t CERTIFICATE_BUFFER_SIZE = 1 << 16;
+
+// ----------------------------------------------------------------------------
+// CertificateWriter
+
+CertificateWriter::CertificateWriter(ostream & output)
+	:_output(output)
+{
+	_buffer.reserve(CERTIFICATE_BUFFER_SIZE + 256);
+}
+
+CertificateWriter::~CertificateWriter()
+{
+	flush();
+}
+
+void CertificateWriter::writeNumber(unsigned n)
+{
+	_buffer += ' ';
+	_buffer += to_string(n);
+}
+
+void CertificateWriter::endLine()
+{
+	_buffer += '\n';
+	if (_buffer.size() >= CERTIFICATE_BUFFER_SIZE)
+	{
+		flush();
+	}
+}
+
+void CertificateWriter::writeInput(unsigned id, bool sign, const Formula & f)
+{
+	ostringstream text;
+	f->printFormula(text);
+
+	_buffer += 'i';
+	writeNumber(id);
+	_buffer += sign ? " T " : " F ";
+	_buffer += text.str();
+	endLine();
+}
+
+void CertificateWriter::writeAlpha(unsigned parent, unsigned first, unsigned second)
+{
+	_buffer += 'a';
+	writeNumber(parent);
+	writeNumber(first);
+	if (second != 0)
+	{
+		writeNumber(second);
+	}
+	endLine();
+}
+
+void CertificateWriter::writeBeta(unsigned parent, unsigned first, unsigned second)
+{
+	_buffer += 'b';
+	writeNumber(parent);
+	writeNumber(first);
+	writeNumber(second);
+	endLine();
+}
+
+void CertificateWriter::writeDelta(unsigned parent, unsigned child, const FunctionSymbol & constant)
+{
+	_buffer += 'd';
+	writeNumber(parent);
+	writeNumber(child);
+	_buffer += ' ';
+	_buffer += constant;
+	endLine();
+}
+
+void CertificateWriter::writeGamma(unsigned parent, unsigned child, const FunctionSymbol & constant)
+{
+	_buffer += 'g';
+	writeNumber(parent);
+	writeNumber(child);
+	_buffer += ' ';
+	_buffer += constant;
+	endLine();
+}
+
+void CertificateWriter::writeSimplification(unsigned parent, unsigned child, const vector<unsigned> & literals)
+{
+	_buffer += 's';
+	writeNumber(parent);
+	writeNumber(child);
+	for (unsigned literal : literals)
+	{
+		writeNumber(literal);
+	}
+	endLine();
+}
+
+void CertificateWriter::writeClosure(unsigned first, unsigned second)
+{
+	_buffer += 'x';
+	writeNumber(first);
+	if (second != 0)
+	{
+		writeNumber(second);
+	}
+	endLine();
+}
+
+void CertificateWriter::writeEqualityClosure()
+{
+	_buffer += "x =";
+	endLine();
+}
+
+void CertificateWriter::writeOpen()
+{
+	_buffer += 'o';
+	endLine();
+}
+
+void CertificateWriter::flush()
+{
+	_output.write(_buffer.data(), _buffer.size());
+	_buffer.clear();
+}
+
+// END CertificateWriter
+// ----------------------------------------------------------------------------
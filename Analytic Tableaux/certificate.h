@@ -0,0 +1,59 @@
+#ifndef _CERTIFICATE_H
+#define _CERTIFICATE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "fol.hpp"
+
+/* Writes the certificate of a tableaux proof: one short line for every rule
+application, with the signed formulae named by numbers, so that its size
+grows with the rules applied and not with the text of the formulae. Only the
+input formulae, as prepared for the tableaux, are written out. The lines are
+
+	i N T|F formula		input N
+	a P C [D]		alpha rule on P giving C and D (one child for negation)
+	b P C D			beta rule on P; the steps of the branch with C follow,
+					and then, if it is closed, those of the branch with D
+	d P C c			delta rule on P giving C with the new constant c
+	g P C c			gamma instance C of P for the constant c
+	s P C L...		P simplified to C by the literals L...
+	x L [M]			the branch is closed by the complementary literals L and M,
+					or by L alone if it is T false or F true
+	x =				the branch is closed by its equalities
+	o				the branch is open
+
+A number is given to a formula the first time it is written, so equal
+formulae may have several numbers. Every branch ends with x or o, so the
+tree is read back in the order of the steps; the certificate ends at the
+first open branch, or where the proof gave up. The lines are collected in
+a buffer and written to the stream in large blocks. */
+class CertificateWriter
+{
+private:
+	ostream & _output;
+	string _buffer;
+
+	void writeNumber(unsigned n);
+	void endLine();
+public:
+	CertificateWriter(ostream & output);
+	// Writes what is left in the buffer
+	~CertificateWriter();
+
+	void writeInput(unsigned id, bool sign, const Formula & f);
+	// The second child is 0 for the rule of a negation
+	void writeAlpha(unsigned parent, unsigned first, unsigned second);
+	void writeBeta(unsigned parent, unsigned first, unsigned second);
+	void writeDelta(unsigned parent, unsigned child, const FunctionSymbol & constant);
+	void writeGamma(unsigned parent, unsigned child, const FunctionSymbol & constant);
+	void writeSimplification(unsigned parent, unsigned child, const vector<unsigned> & literals);
+	// The second literal is 0 if the first closes the branch alone
+	void writeClosure(unsigned first, unsigned second);
+	void writeEqualityClosure();
+	void writeOpen();
+	void flush();
+};
+
+#endif // _CERTIFICATE_H
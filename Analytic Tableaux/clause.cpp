@@ -0,0 +1,393 @@
+#include "stdafx.h"
+#include "clause.h"
+
+#include <sstream>
+
+// ----------------------------------------------------------------------------
+// Clausifier
+
+Clausifier::Clausifier()
+	:_nextVariable(0),
+	_nextSkolem(0)
+{}
+
+vector<Clause> Clausifier::clausify(const Formula & f)
+{
+	Formula transformed = transform(f->releaseIff()->absorbConstants(), true, vector<Term>(), Substitution());
+
+	vector<Clause> clauses;
+	toClauses(transformed, clauses);
+	return clauses;
+}
+
+vector<Clause> Clausifier::clausifyNegation(const Formula & f)
+{
+	return clausify(make_shared<Not>(f));
+}
+
+Formula Clausifier::transform(const Formula & f, bool positive, const vector<Term> & universals, const Substitution & binding)
+{
+	switch (f->getType())
+	{
+		case BaseFormula::T_TRUE:
+		case BaseFormula::T_FALSE:
+		{
+			bool value = (f->getType() == BaseFormula::T_TRUE) == positive;
+			return value ? Formula(make_shared<True>()) : Formula(make_shared<False>());
+		}
+		case BaseFormula::T_ATOM:
+		{
+			Atom * pAtom = (Atom *)f.get();
+			vector<Term> boundOps;
+			for (unsigned i = 0; i < pAtom->getOperands().size(); ++i)
+			{
+				boundOps.push_back(bindTerm(pAtom->getOperands()[i], binding));
+			}
+
+			// A disequality is a negated equality
+			if (pAtom->getSymbol() == "~=" && boundOps.size() == 2)
+			{
+				Formula atom = make_shared<Atom>("=", boundOps);
+				return positive ? Formula(make_shared<Not>(atom)) : atom;
+			}
+
+			Formula atom = make_shared<Atom>(pAtom->getSymbol(), boundOps);
+			return positive ? atom : Formula(make_shared<Not>(atom));
+		}
+		case BaseFormula::T_NOT:
+			return transform(((Not *)f.get())->getOperand(), !positive, universals, binding);
+		case BaseFormula::T_AND:
+		case BaseFormula::T_OR:
+		{
+			BinaryConjective * pBinary = (BinaryConjective *)f.get();
+			Formula op1 = transform(pBinary->getOperand1(), positive, universals, binding);
+			Formula op2 = transform(pBinary->getOperand2(), positive, universals, binding);
+
+			// Negation swaps conjunctions and disjunctions
+			if ((f->getType() == BaseFormula::T_AND) == positive)
+			{
+				return make_shared<And>(op1, op2);
+			}
+			return make_shared<Or>(op1, op2);
+		}
+		case BaseFormula::T_IMP:
+		{
+			// X => Y is ~X \/ Y, and ~(X => Y) is X /\ ~Y
+			Imp * pImp = (Imp *)f.get();
+			Formula op1 = transform(pImp->getOperand1(), !positive, universals, binding);
+			Formula op2 = transform(pImp->getOperand2(), positive, universals, binding);
+
+			if (positive)
+			{
+				return make_shared<Or>(op1, op2);
+			}
+			return make_shared<And>(op1, op2);
+		}
+		case BaseFormula::T_IFF:
+			return transform(f->releaseIff(), positive, universals, binding);
+		case BaseFormula::T_FORALL:
+		case BaseFormula::T_EXISTS:
+		{
+			Quantifier * pQuant = (Quantifier *)f.get();
+			Substitution innerBinding(binding);
+			vector<Term> innerUniversals(universals);
+
+			if ((f->getType() == BaseFormula::T_FORALL) == positive)
+			{
+				// A universal quantifier gets a fresh variable
+				Term v = make_shared<VariableTerm>("X" + to_string(_nextVariable++));
+				innerBinding[pQuant->getVariable()] = v;
+				innerUniversals.push_back(v);
+			}
+			else
+			{
+				// An existential quantifier gets a Skolem function of the universals in scope
+				innerBinding[pQuant->getVariable()] = make_shared<FunctionTerm>("$sk" + to_string(_nextSkolem++), universals);
+			}
+
+			return transform(pQuant->getOperand(), positive, innerUniversals, innerBinding);
+		}
+		default:
+			throw "Not applicable: Unknown formula type in clausification";
+	}
+}
+
+Term Clausifier::bindTerm(const Term & t, const Substitution & binding)
+{
+	if (t->getType() == BaseTerm::TT_VARIABLE)
+	{
+		const Variable & v = ((VariableTerm *)t.get())->getVariable();
+
+		Substitution::const_iterator iter = binding.find(v);
+		if (iter != binding.cend())
+		{
+			return iter->second;
+		}
+
+		// A free variable of f is universally quantified, so in ~f it becomes a Skolem constant
+		iter = _freeVariables.find(v);
+		if (iter != _freeVariables.cend())
+		{
+			return iter->second;
+		}
+
+		Term skolemConstant = make_shared<FunctionTerm>("$sk" + to_string(_nextSkolem++));
+		_freeVariables[v] = skolemConstant;
+		return skolemConstant;
+	}
+
+	FunctionTerm * pFunction = (FunctionTerm *)t.get();
+	vector<Term> boundOps;
+	for (unsigned i = 0; i < pFunction->getOperands().size(); ++i)
+	{
+		boundOps.push_back(bindTerm(pFunction->getOperands()[i], binding));
+	}
+
+	return make_shared<FunctionTerm>(pFunction->getSymbol(), boundOps);
+}
+
+void Clausifier::toClauses(const Formula & f, vector<Clause> & clauses) const
+{
+	switch (f->getType())
+	{
+		case BaseFormula::T_TRUE:
+			return;
+		case BaseFormula::T_FALSE:
+			clauses.push_back(Clause());
+			return;
+		case BaseFormula::T_ATOM:
+			clauses.push_back(Clause(1, Literal{ true, f }));
+			return;
+		case BaseFormula::T_NOT:
+			clauses.push_back(Clause(1, Literal{ false, ((Not *)f.get())->getOperand() }));
+			return;
+		case BaseFormula::T_AND:
+			toClauses(((And *)f.get())->getOperand1(), clauses);
+			toClauses(((And *)f.get())->getOperand2(), clauses);
+			return;
+		case BaseFormula::T_OR:
+		{
+			// Distribute the disjunction over the clauses of both operands
+			vector<Clause> clauses1, clauses2;
+			toClauses(((Or *)f.get())->getOperand1(), clauses1);
+			toClauses(((Or *)f.get())->getOperand2(), clauses2);
+
+			for (unsigned i = 0; i < clauses1.size(); ++i)
+			{
+				for (unsigned j = 0; j < clauses2.size(); ++j)
+				{
+					Clause c(clauses1[i]);
+					c.insert(c.end(), clauses2[j].begin(), clauses2[j].end());
+					if (normalizeClause(c))
+					{
+						clauses.push_back(c);
+					}
+				}
+			}
+			return;
+		}
+		default:
+			throw "Not applicable: formula is not in negation normal form";
+	}
+}
+
+// END Clausifier
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Other functions
+
+bool normalizeClause(Clause & c)
+{
+	Clause normalized;
+
+	for (unsigned i = 0; i < c.size(); ++i)
+	{
+		bool repeated = false;
+		for (unsigned j = 0; j < normalized.size(); ++j)
+		{
+			if (normalized[j].atom->equalTo(c[i].atom))
+			{
+				if (normalized[j].sign != c[i].sign)
+				{
+					return false;
+				}
+				repeated = true;
+				break;
+			}
+		}
+
+		if (!repeated)
+		{
+			normalized.push_back(c[i]);
+		}
+	}
+
+	c = move(normalized);
+	return true;
+}
+
+Clause renameClauseVariables(const Clause & c, const string & prefix)
+{
+	deque<Variable> d_variables;
+	for (unsigned i = 0; i < c.size(); ++i)
+	{
+		const vector<Term> & ops = ((Atom *)c[i].atom.get())->getOperands();
+		for (unsigned j = 0; j < ops.size(); ++j)
+		{
+			ops[j]->getVariables(d_variables);
+		}
+	}
+
+	if (d_variables.empty())
+	{
+		return c;
+	}
+
+	Substitution renaming;
+	for (unsigned i = 0; i < d_variables.size(); ++i)
+	{
+		renaming[d_variables[i]] = make_shared<VariableTerm>(prefix + to_string(i));
+	}
+
+	Clause renamed;
+	renamed.reserve(c.size());
+	for (unsigned i = 0; i < c.size(); ++i)
+	{
+		renamed.push_back(Literal{ c[i].sign, applyRenaming(c[i].atom, renaming) });
+	}
+
+	return renamed;
+}
+
+string getClauseKey(const Clause & c)
+{
+	ostringstream key;
+	key << renameClauseVariables(c, "V");
+	return key.str();
+}
+
+Clause applySubstitution(const Clause & c, const Substitution & s)
+{
+	Clause substituted;
+	substituted.reserve(c.size());
+
+	for (unsigned i = 0; i < c.size(); ++i)
+	{
+		substituted.push_back(Literal{ c[i].sign, applySubstitution(c[i].atom, s) });
+	}
+
+	return substituted;
+}
+
+static bool subsumesFrom(const Clause & c, unsigned index, const Clause & d, const Substitution & s)
+{
+	if (index == c.size())
+	{
+		return true;
+	}
+
+	// Try every literal of d that the next literal of c can be mapped onto
+	for (unsigned k = 0; k < d.size(); ++k)
+	{
+		if (d[k].sign != c[index].sign)
+		{
+			continue;
+		}
+
+		Substitution extended(s);
+		if (matchAtoms(c[index].atom, d[k].atom, extended) && subsumesFrom(c, index + 1, d, extended))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool subsumes(const Clause & c, const Clause & d)
+{
+	// A longer clause would only subsume d by merging its literals
+	if (c.size() > d.size())
+	{
+		return false;
+	}
+
+	return subsumesFrom(c, 0, d, Substitution());
+}
+
+static unsigned getTermWeight(const Term & t)
+{
+	if (t->getType() == BaseTerm::TT_VARIABLE)
+	{
+		return 1;
+	}
+
+	unsigned weight = 1;
+	const vector<Term> & ops = ((FunctionTerm *)t.get())->getOperands();
+	for (unsigned i = 0; i < ops.size(); ++i)
+	{
+		weight += getTermWeight(ops[i]);
+	}
+	return weight;
+}
+
+unsigned getClauseWeight(const Clause & c)
+{
+	unsigned weight = 0;
+	for (unsigned i = 0; i < c.size(); ++i)
+	{
+		weight += 1;
+		const vector<Term> & ops = ((Atom *)c[i].atom.get())->getOperands();
+		for (unsigned j = 0; j < ops.size(); ++j)
+		{
+			weight += getTermWeight(ops[j]);
+		}
+	}
+	return weight;
+}
+
+bool containsEquality(const vector<Clause> & clauses)
+{
+	for (const Clause & c : clauses)
+	{
+		for (const Literal & l : c)
+		{
+			const PredicateSymbol & symbol = ((Atom *)l.atom.get())->getSymbol();
+			if (symbol == "=" || symbol == "~=")
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+ostream & operator << (ostream & ostr, const Literal & l)
+{
+	if (!l.sign)
+	{
+		ostr << "~";
+	}
+	l.atom->printFormula(ostr);
+	return ostr;
+}
+
+ostream & operator << (ostream & ostr, const Clause & c)
+{
+	if (c.empty())
+	{
+		ostr << "[]";
+		return ostr;
+	}
+
+	for (unsigned i = 0; i < c.size(); ++i)
+	{
+		if (i != 0)
+		{
+			ostr << " | ";
+		}
+		ostr << c[i];
+	}
+	return ostr;
+}
@@ -0,0 +1,56 @@
+#ifndef _CLAUSE_H
+#define _CLAUSE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "fol.hpp"
+#include "unification.h"
+
+struct Literal
+{
+	// true for a positive literal, false for a negated one
+	bool sign;
+	Formula atom;
+};
+
+typedef vector<Literal> Clause;
+
+class Clausifier
+{
+private:
+	unsigned _nextVariable;
+	unsigned _nextSkolem;
+	Substitution _freeVariables;
+
+	Formula transform(const Formula & f, bool positive, const vector<Term> & universals, const Substitution & binding);
+	Term bindTerm(const Term & t, const Substitution & binding);
+	void toClauses(const Formula & f, vector<Clause> & clauses) const;
+public:
+	Clausifier();
+
+	// Clauses of the Skolemized conjunctive normal form of f
+	vector<Clause> clausify(const Formula & f);
+	// Clauses of ~f, which are unsatisfiable if and only if f is valid
+	vector<Clause> clausifyNegation(const Formula & f);
+};
+
+// Removes repeated literals; returns false if the clause contains a complementary pair
+bool normalizeClause(Clause & c);
+// Renames the variables of the clause to prefix0, prefix1, ... in order of appearance
+Clause renameClauseVariables(const Clause & c, const string & prefix);
+// Text which is the same for two clauses if and only if they are variants of each other
+string getClauseKey(const Clause & c);
+Clause applySubstitution(const Clause & c, const Substitution & s);
+// Checks whether some instance of c is a subset of d
+bool subsumes(const Clause & c, const Clause & d);
+// Number of predicate, function and variable symbols in the clause
+unsigned getClauseWeight(const Clause & c);
+// Checks whether some clause has an equality literal
+bool containsEquality(const vector<Clause> & clauses);
+
+ostream & operator << (ostream & ostr, const Literal & l);
+ostream & operator << (ostream & ostr, const Clause & c);
+
+#endif // _CLAUSE_H
@@ -0,0 +1,298 @@
+#include "stdafx.h"
+#include "congruence.h"
+
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+// CongruenceClosure
+
+CongruenceClosure::CongruenceClosure()
+	:_inconsistent(false)
+{
+	// The nodes for the logic constants are never backtracked
+	_true = addNode("$true", vector<unsigned>());
+	_false = addNode("$false", vector<unsigned>());
+	_trail.clear();
+}
+
+unsigned CongruenceClosure::find(unsigned node) const
+{
+	// No path compression, so that a union can be undone by resetting one parent
+	while (_parents[node] != node)
+	{
+		node = _parents[node];
+	}
+	return node;
+}
+
+CongruenceClosure::Signature CongruenceClosure::getSignature(unsigned node) const
+{
+	Signature signature(_nodes[node].symbol, _nodes[node].args);
+	for (unsigned & arg : signature.second)
+	{
+		arg = find(arg);
+	}
+	return signature;
+}
+
+unsigned CongruenceClosure::addNode(const string & symbol, const vector<unsigned> & args)
+{
+	Signature signature(symbol, args);
+	for (unsigned & arg : signature.second)
+	{
+		arg = find(arg);
+	}
+
+	// A congruent node stands for the new term as well
+	map<Signature, unsigned>::const_iterator iter = _signatures.find(signature);
+	if (iter != _signatures.cend())
+	{
+		return iter->second;
+	}
+
+	unsigned id = _nodes.size();
+	_nodes.push_back(Node{ symbol, args });
+	_parents.push_back(id);
+	_sizes.push_back(1);
+	_uses.push_back(vector<unsigned>());
+	_trail.push_back(UndoEntry{ U_NODE, id, 0, Signature() });
+
+	_signatures[signature] = id;
+	_trail.push_back(UndoEntry{ U_SIGNATURE, id, 0, signature });
+
+	for (unsigned i = 0; i < signature.second.size(); ++i)
+	{
+		unsigned rep = signature.second[i];
+		if (std::find(signature.second.cbegin(), signature.second.cbegin() + i, rep) != signature.second.cbegin() + i)
+		{
+			continue;
+		}
+
+		_trail.push_back(UndoEntry{ U_USES, rep, (unsigned)_uses[rep].size(), Signature() });
+		_uses[rep].push_back(id);
+	}
+
+	return id;
+}
+
+unsigned CongruenceClosure::addTerm(const Term & t)
+{
+	if (t->getType() == BaseTerm::TT_VARIABLE)
+	{
+		// Free variables are treated as constants
+		return addNode("V:" + ((VariableTerm *)t.get())->getVariable(), vector<unsigned>());
+	}
+
+	FunctionTerm * pFunction = (FunctionTerm *)t.get();
+	vector<unsigned> args;
+	for (unsigned i = 0; i < pFunction->getOperands().size(); ++i)
+	{
+		args.push_back(addTerm(pFunction->getOperands()[i]));
+	}
+
+	return addNode("F:" + pFunction->getSymbol(), args);
+}
+
+unsigned CongruenceClosure::addAtom(const Atom * pAtom)
+{
+	vector<unsigned> args;
+	for (unsigned i = 0; i < pAtom->getOperands().size(); ++i)
+	{
+		args.push_back(addTerm(pAtom->getOperands()[i]));
+	}
+
+	return addNode("P:" + pAtom->getSymbol(), args);
+}
+
+void CongruenceClosure::merge(unsigned a, unsigned b)
+{
+	vector< pair<unsigned, unsigned> > pending(1, make_pair(a, b));
+
+	while (!pending.empty())
+	{
+		unsigned ra = find(pending.back().first);
+		unsigned rb = find(pending.back().second);
+		pending.pop_back();
+
+		if (ra == rb)
+		{
+			continue;
+		}
+
+		// The smaller class is merged into the larger one
+		if (_sizes[ra] > _sizes[rb])
+		{
+			swap(ra, rb);
+		}
+
+		_parents[ra] = rb;
+		_sizes[rb] += _sizes[ra];
+		_trail.push_back(UndoEntry{ U_UNION, ra, rb, Signature() });
+
+		// The parents of the merged class may have become congruent to other nodes
+		_trail.push_back(UndoEntry{ U_USES, rb, (unsigned)_uses[rb].size(), Signature() });
+		vector<unsigned> uses(_uses[ra]);
+		for (unsigned p : uses)
+		{
+			Signature signature = getSignature(p);
+			map<Signature, unsigned>::const_iterator iter = _signatures.find(signature);
+			if (iter != _signatures.cend())
+			{
+				if (find(iter->second) != find(p))
+				{
+					pending.push_back(make_pair(p, iter->second));
+				}
+			}
+			else
+			{
+				_signatures[signature] = p;
+				_trail.push_back(UndoEntry{ U_SIGNATURE, p, 0, signature });
+			}
+
+			_uses[rb].push_back(p);
+		}
+	}
+
+	checkConsistency();
+}
+
+void CongruenceClosure::addDisequality(unsigned a, unsigned b)
+{
+	_disequalities.push_back(make_pair(a, b));
+	_trail.push_back(UndoEntry{ U_DISEQUALITY, a, b, Signature() });
+
+	checkConsistency();
+}
+
+void CongruenceClosure::checkConsistency()
+{
+	if (_inconsistent)
+	{
+		return;
+	}
+
+	bool inconsistent = find(_true) == find(_false);
+	for (unsigned i = 0; !inconsistent && i < _disequalities.size(); ++i)
+	{
+		inconsistent = find(_disequalities[i].first) == find(_disequalities[i].second);
+	}
+
+	if (inconsistent)
+	{
+		_inconsistent = true;
+		_trail.push_back(UndoEntry{ U_INCONSISTENT, 0, 0, Signature() });
+	}
+}
+
+void CongruenceClosure::assertLiteral(const Formula & atom, bool sign)
+{
+	Atom * pAtom = (Atom *)atom.get();
+	const PredicateSymbol & symbol = pAtom->getSymbol();
+
+	if ((symbol == "=" || symbol == "~=") && pAtom->getOperands().size() == 2)
+	{
+		unsigned lop = addTerm(pAtom->getOperands()[0]);
+		unsigned rop = addTerm(pAtom->getOperands()[1]);
+
+		// T (s ~= t) is the same as F (s = t)
+		if ((symbol == "=") == sign)
+		{
+			merge(lop, rop);
+		}
+		else
+		{
+			addDisequality(lop, rop);
+		}
+	}
+	else
+	{
+		merge(addAtom(pAtom), sign ? _true : _false);
+	}
+}
+
+bool CongruenceClosure::isInconsistent() const
+{
+	return _inconsistent;
+}
+
+unsigned CongruenceClosure::getClass(const Term & t)
+{
+	return find(addTerm(t));
+}
+
+bool CongruenceClosure::isTrue(const Atom * pAtom)
+{
+	return find(addAtom(pAtom)) == find(_true);
+}
+
+unsigned CongruenceClosure::getLevel() const
+{
+	return _trail.size();
+}
+
+void CongruenceClosure::backtrack(unsigned level)
+{
+	while (_trail.size() > level)
+	{
+		const UndoEntry & entry = _trail.back();
+		switch (entry.type)
+		{
+			case U_NODE:
+				_nodes.pop_back();
+				_parents.pop_back();
+				_sizes.pop_back();
+				_uses.pop_back();
+				break;
+			case U_UNION:
+				_parents[entry.first] = entry.first;
+				_sizes[entry.second] -= _sizes[entry.first];
+				break;
+			case U_USES:
+				_uses[entry.first].resize(entry.second);
+				break;
+			case U_SIGNATURE:
+				_signatures.erase(entry.signature);
+				break;
+			case U_DISEQUALITY:
+				_disequalities.pop_back();
+				break;
+			case U_INCONSISTENT:
+				_inconsistent = false;
+				break;
+		}
+		_trail.pop_back();
+	}
+}
+
+// END CongruenceClosure
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Other functions
+
+bool containsEquality(const Formula & f)
+{
+	switch (f->getType())
+	{
+		case BaseFormula::T_ATOM:
+		{
+			const PredicateSymbol & symbol = ((Atom *)f.get())->getSymbol();
+			return symbol == "=" || symbol == "~=";
+		}
+		case BaseFormula::T_NOT:
+			return containsEquality(((Not *)f.get())->getOperand());
+		case BaseFormula::T_AND:
+		case BaseFormula::T_OR:
+		case BaseFormula::T_IMP:
+		case BaseFormula::T_IFF:
+		{
+			BinaryConjective * pBinary = (BinaryConjective *)f.get();
+			return containsEquality(pBinary->getOperand1()) || containsEquality(pBinary->getOperand2());
+		}
+		case BaseFormula::T_FORALL:
+		case BaseFormula::T_EXISTS:
+			return containsEquality(((Quantifier *)f.get())->getOperand());
+		default:
+			return false;
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef _CONGRUENCE_H
+#define _CONGRUENCE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "fol.hpp"
+
+/* Incremental congruence closure over the ground literals of a branch.
+Terms and atoms are nodes of a union-find structure without path compression,
+so every change can be undone from a trail when the tableaux backtracks. Atoms
+are merged with the nodes for true and false, so a branch is inconsistent if
+those two become congruent, or if the sides of a disequality do. */
+class CongruenceClosure
+{
+private:
+	typedef pair< string, vector<unsigned> > Signature;
+
+	struct Node
+	{
+		string symbol;
+		vector<unsigned> args;
+	};
+
+	enum UndoType { U_NODE, U_UNION, U_USES, U_SIGNATURE, U_DISEQUALITY, U_INCONSISTENT };
+
+	struct UndoEntry
+	{
+		UndoType type;
+		unsigned first, second;
+		Signature signature;
+	};
+
+	vector<Node> _nodes;
+	vector<unsigned> _parents;
+	vector<unsigned> _sizes;
+	vector< vector<unsigned> > _uses;
+	map<Signature, unsigned> _signatures;
+	vector< pair<unsigned, unsigned> > _disequalities;
+	vector<UndoEntry> _trail;
+	unsigned _true, _false;
+	bool _inconsistent;
+
+	unsigned find(unsigned node) const;
+	Signature getSignature(unsigned node) const;
+	unsigned addNode(const string & symbol, const vector<unsigned> & args);
+	unsigned addTerm(const Term & t);
+	unsigned addAtom(const Atom * pAtom);
+	void merge(unsigned a, unsigned b);
+	void addDisequality(unsigned a, unsigned b);
+	void checkConsistency();
+public:
+	CongruenceClosure();
+
+	// Asserts a signed ground literal: an atom, an equality or a disequality
+	void assertLiteral(const Formula & atom, bool sign);
+	bool isInconsistent() const;
+	// The class of the term, the same for congruent terms; a new term is added to the nodes
+	unsigned getClass(const Term & t);
+	// Whether the atom is congruent to one asserted true; a new atom is added to the nodes
+	bool isTrue(const Atom * pAtom);
+
+	// Everything asserted after getLevel() returned the given level is undone by backtrack
+	unsigned getLevel() const;
+	void backtrack(unsigned level);
+};
+
+// Checks whether the formula contains an equality or a disequality
+bool containsEquality(const Formula & f);
+
+#endif // _CONGRUENCE_H
@@ -28,6 +28,15 @@ void VariableTerm::getConstants(deque<FunctionSymbol> & d_constants) const
 	(void)d_constants;
 }
 
+void VariableTerm::getVariables(deque<Variable> & d_variables) const
+{
+	deque<Variable>::const_iterator iter = find(d_variables.cbegin(), d_variables.cend(), _v);
+	if (iter == d_variables.cend())
+	{
+		d_variables.push_back(_v);
+	}
+}
+
 bool VariableTerm::equalTo(const Term & t) const
 {
 	if (t->getType() != BaseTerm::TT_VARIABLE)
@@ -55,6 +64,11 @@ Term VariableTerm::instantiate(const Variable & v, const Term & t)
 	}
 }
 
+bool VariableTerm::containsVariable(const Variable & v) const
+{
+	return v == _v;
+}
+
 // END VariableTerm
 // ----------------------------------------------------------------------------
 
@@ -66,6 +80,11 @@ FunctionTerm::FunctionTerm(const FunctionSymbol & f, const vector<Term> & ops)
 	_ops(ops)
 {}
 
+FunctionTerm::FunctionTerm(const FunctionSymbol & f, vector<Term> && ops)
+	:_f(f),
+	_ops(move(ops))
+{}
+
 BaseTerm::Type FunctionTerm::getType() const
 {
 	return TT_FUNCTION;
@@ -116,6 +135,14 @@ void FunctionTerm::getConstants(deque<FunctionSymbol> & d_constants) const
 	}
 }
 
+void FunctionTerm::getVariables(deque<Variable> & d_variables) const
+{
+	for (unsigned i = 0; i < _ops.size(); ++i)
+	{
+		_ops[i]->getVariables(d_variables);
+	}
+}
+
 bool FunctionTerm::equalTo(const Term & t) const
 {
 	if (t->getType() != BaseTerm::TT_FUNCTION)
@@ -157,6 +184,19 @@ Term FunctionTerm::instantiate(const Variable & v, const Term & t)
 	return make_shared<FunctionTerm>(_f, instOps);
 }
 
+bool FunctionTerm::containsVariable(const Variable & v) const
+{
+	for (unsigned i = 0; i < _ops.size(); ++i)
+	{
+		if (_ops[i]->containsVariable(v))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 // END FunctionTerm
 // ----------------------------------------------------------------------------
 
@@ -173,6 +213,16 @@ Formula AtomicFormula::absorbConstants()
 	return shared_from_this();
 }
 
+Formula AtomicFormula::substituteAtom(const Formula & a, const Formula & c)
+{
+	if (getType() == T_ATOM && equalTo(a))
+	{
+		return c;
+	}
+
+	return shared_from_this();
+}
+
 // END AtomicFormula
 // ----------------------------------------------------------------------------
 
@@ -259,6 +309,12 @@ Atom::Atom(const PredicateSymbol & p,
 	_ops(ops)
 {}
 
+Atom::Atom(const PredicateSymbol & p,
+	vector<Term> && ops)
+	:_p(p),
+	_ops(move(ops))
+{}
+
 const PredicateSymbol & Atom::getSymbol() const
 {
 	return _p;
@@ -305,6 +361,11 @@ bool Atom::equalTo(const Formula & f) const
 	}
 
 	Atom * fa = (Atom*)f.get();
+	if (fa->getSymbol() != _p)
+	{
+		return false;
+	}
+
 	if (fa->getOperands().size() != _ops.size())
 	{
 		return false;
@@ -428,6 +489,18 @@ Formula Not::instantiate(const Variable & v, const Term & t)
 	return make_shared<Not>(_op->instantiate(v, t));
 }
 
+Formula Not::substituteAtom(const Formula & a, const Formula & c)
+{
+	Formula substOp = _op->substituteAtom(a, c);
+
+	if (substOp == _op)
+	{
+		return shared_from_this();
+	}
+
+	return make_shared<Not>(substOp);
+}
+
 // END Not
 // ----------------------------------------------------------------------------
 
@@ -553,6 +626,19 @@ Formula And::instantiate(const Variable & v, const Term & t)
 	return make_shared<And>(_op1->instantiate(v, t), _op2->instantiate(v, t));
 }
 
+Formula And::substituteAtom(const Formula & a, const Formula & c)
+{
+	Formula substOp1 = _op1->substituteAtom(a, c);
+	Formula substOp2 = _op2->substituteAtom(a, c);
+
+	if (substOp1 == _op1 && substOp2 == _op2)
+	{
+		return shared_from_this();
+	}
+
+	return make_shared<And>(substOp1, substOp2);
+}
+
 // END And
 // ----------------------------------------------------------------------------
 
@@ -649,6 +735,19 @@ Formula Or::instantiate(const Variable & v, const Term & t)
 	return make_shared<Or>(_op1->instantiate(v, t), _op2->instantiate(v, t));
 }
 
+Formula Or::substituteAtom(const Formula & a, const Formula & c)
+{
+	Formula substOp1 = _op1->substituteAtom(a, c);
+	Formula substOp2 = _op2->substituteAtom(a, c);
+
+	if (substOp1 == _op1 && substOp2 == _op2)
+	{
+		return shared_from_this();
+	}
+
+	return make_shared<Or>(substOp1, substOp2);
+}
+
 // END Or
 // ----------------------------------------------------------------------------
 
@@ -747,6 +846,19 @@ Formula Imp::instantiate(const Variable & v, const Term & t)
 	return make_shared<Imp>(_op1->instantiate(v, t), _op2->instantiate(v, t));
 }
 
+Formula Imp::substituteAtom(const Formula & a, const Formula & c)
+{
+	Formula substOp1 = _op1->substituteAtom(a, c);
+	Formula substOp2 = _op2->substituteAtom(a, c);
+
+	if (substOp1 == _op1 && substOp2 == _op2)
+	{
+		return shared_from_this();
+	}
+
+	return make_shared<Imp>(substOp1, substOp2);
+}
+
 // END Imp
 // ----------------------------------------------------------------------------
 
@@ -795,11 +907,7 @@ Formula Iff::absorbConstants()
 	Formula absOp1 = _op1->absorbConstants();
 	Formula absOp2 = _op2->absorbConstants();
 
-	if (absOp1->getType() == T_FALSE || absOp2->getType() == T_FALSE)
-	{
-		return make_shared<True>();
-	}
-	else if (absOp1->getType() == T_TRUE)
+	if (absOp1->getType() == T_TRUE)
 	{
 		return absOp2;
 	}
@@ -809,7 +917,7 @@ Formula Iff::absorbConstants()
 	}
 	else if (absOp1->getType() == T_FALSE)
 	{
-		return make_shared<Not>(absOp2);
+		return make_shared<Not>(absOp2)->absorbConstants();
 	}
 	else if (absOp2->getType() == T_FALSE)
 	{
@@ -846,6 +954,19 @@ Formula Iff::instantiate(const Variable & v, const Term & t)
 	return make_shared<Iff>(_op1->instantiate(v, t), _op2->instantiate(v, t));
 }
 
+Formula Iff::substituteAtom(const Formula & a, const Formula & c)
+{
+	Formula substOp1 = _op1->substituteAtom(a, c);
+	Formula substOp2 = _op2->substituteAtom(a, c);
+
+	if (substOp1 == _op1 && substOp2 == _op2)
+	{
+		return shared_from_this();
+	}
+
+	return make_shared<Iff>(substOp1, substOp2);
+}
+
 // END Iff
 // ----------------------------------------------------------------------------
 
@@ -889,7 +1010,7 @@ BaseFormula::Type Forall::getType() const
 
 void Forall::printFormula(ostream & ostr) const
 {
-	cout << "![" << _v << "] : ";
+	ostr << "![" << _v << "] : ";
 
 	Type op_type = _op->getType();
 
@@ -945,7 +1066,7 @@ Formula Forall::absorbConstants()
 	}
 	else
 	{
-		return make_shared<Exists>(_v, absOp);
+		return make_shared<Forall>(_v, absOp);
 	}
 }
 
@@ -961,6 +1082,28 @@ Formula Forall::instantiate(const Variable & v, const Term & t)
 	}
 }
 
+Formula Forall::substituteAtom(const Formula & a, const Formula & c)
+{
+	// Occurrences of the atom which mention the bound variable are not free in the operand
+	const vector<Term> & atomOps = ((Atom *)a.get())->getOperands();
+	for (unsigned i = 0; i < atomOps.size(); ++i)
+	{
+		if (atomOps[i]->containsVariable(_v))
+		{
+			return shared_from_this();
+		}
+	}
+
+	Formula substOp = _op->substituteAtom(a, c);
+
+	if (substOp == _op)
+	{
+		return shared_from_this();
+	}
+
+	return make_shared<Forall>(_v, substOp);
+}
+
 // END Forall
 // ----------------------------------------------------------------------------
 
@@ -978,7 +1121,7 @@ BaseFormula::Type Exists::getType() const
 
 void Exists::printFormula(ostream & ostr) const
 {
-	cout << "?[" << _v << "] : ";
+	ostr << "?[" << _v << "] : ";
 
 	Type op_type = _op->getType();
 
@@ -1050,6 +1193,28 @@ Formula Exists::instantiate(const Variable & v, const Term & t)
 	}
 }
 
+Formula Exists::substituteAtom(const Formula & a, const Formula & c)
+{
+	// Occurrences of the atom which mention the bound variable are not free in the operand
+	const vector<Term> & atomOps = ((Atom *)a.get())->getOperands();
+	for (unsigned i = 0; i < atomOps.size(); ++i)
+	{
+		if (atomOps[i]->containsVariable(_v))
+		{
+			return shared_from_this();
+		}
+	}
+
+	Formula substOp = _op->substituteAtom(a, c);
+
+	if (substOp == _op)
+	{
+		return shared_from_this();
+	}
+
+	return make_shared<Exists>(_v, substOp);
+}
+
 // END Exists
 // ----------------------------------------------------------------------------
 
@@ -24,7 +24,9 @@ public:
 	virtual Type getType() const = 0;
 	virtual void printTerm(ostream & ostr) const = 0;
 	virtual void getConstants(deque<FunctionSymbol> & d_constants) const = 0;
+	virtual void getVariables(deque<Variable> & d_variables) const = 0;
 	virtual bool equalTo(const Term & t) const = 0;
+	virtual bool containsVariable(const Variable & v) const = 0;
 	virtual Term instantiate(const Variable & v, const Term & t) = 0;
 
 	virtual ~BaseTerm() {}
@@ -41,7 +43,9 @@ public:
 	const Variable & getVariable() const;
 	virtual void printTerm(ostream & ostr) const;
 	virtual void getConstants(deque<FunctionSymbol> & d_constants) const;
+	virtual void getVariables(deque<Variable> & d_variables) const;
 	virtual bool equalTo(const Term & t) const;
+	virtual bool containsVariable(const Variable & v) const;
 	virtual Term instantiate(const Variable & v, const Term & t);
 };
 
@@ -53,13 +57,17 @@ private:
 public:
 	FunctionTerm(const FunctionSymbol & f,
 		const vector<Term> & ops = vector<Term>());
+	FunctionTerm(const FunctionSymbol & f,
+		vector<Term> && ops);
 
 	virtual Type getType() const;
 	const FunctionSymbol & getSymbol() const;
 	const vector<Term> & getOperands() const;
 	virtual void printTerm(ostream & ostr) const;
 	virtual void getConstants(deque<FunctionSymbol> & d_constants) const;
+	virtual void getVariables(deque<Variable> & d_variables) const;
 	virtual bool equalTo(const Term & t) const;
+	virtual bool containsVariable(const Variable & v) const;
 	virtual Term instantiate(const Variable & v, const Term & t);
 };
 
@@ -82,6 +90,10 @@ public:
 	virtual void getConstants(deque<FunctionSymbol> & d_constants) const = 0;
 	virtual bool equalTo(const Formula & f) const = 0;
 	virtual Formula instantiate(const Variable & v, const Term & t) = 0;
+	/* Replaces every free occurrence of the atom a with the logic constant c.
+	The formula itself is returned if a does not occur in it, so the caller
+	only needs to call absorbConstants() when the result is a new formula. */
+	virtual Formula substituteAtom(const Formula & a, const Formula & c) = 0;
 
 	virtual ~BaseFormula() {}
 };
@@ -91,6 +103,7 @@ class AtomicFormula : public BaseFormula
 public:
 	virtual Formula releaseIff();
 	virtual Formula absorbConstants();
+	virtual Formula substituteAtom(const Formula & a, const Formula & c);
 };
 
 class LogicConstant : public AtomicFormula
@@ -125,6 +138,8 @@ protected:
 public:
 	Atom(const PredicateSymbol & p,
 		const vector<Term> & ops = vector<Term>());
+	Atom(const PredicateSymbol & p,
+		vector<Term> && ops);
 
 	const PredicateSymbol & getSymbol() const;
 	const vector<Term> & getOperands() const;
@@ -163,19 +178,9 @@ public:
 		_ops[1]->printTerm(ostr);
 	}
 
-	virtual Formula releaseIff()
-	{
-		throw "Not applicable!";
-	}
-	
-	virtual Formula absorbConstants()
-	{
-		throw "Not applicable!";
-	}
-	
 	virtual Formula instantiate(const Variable & v, const Term & t)
 	{
-		throw "Not applicable!";
+		return make_shared<Equality>(_ops[0]->instantiate(v, t), _ops[1]->instantiate(v, t));
 	}
 };
 
@@ -207,19 +212,9 @@ public:
 		_ops[1]->printTerm(ostr);
 	}
 
-	virtual Formula releaseIff()
-	{
-		throw "Not applicable!";
-	}
-	
-	virtual Formula absorbConstants()
-	{
-		throw "Not applicable!";
-	}
-	
 	virtual Formula instantiate(const Variable & v, const Term & t)
 	{
-		throw "Not applicable!";
+		return make_shared<Disequality>(_ops[0]->instantiate(v, t), _ops[1]->instantiate(v, t));
 	}
 };
 
@@ -246,6 +241,7 @@ public:
 	virtual Formula absorbConstants();
 	virtual bool equalTo(const Formula & f) const;
 	virtual Formula instantiate(const Variable & v, const Term & t);
+	virtual Formula substituteAtom(const Formula & a, const Formula & c);
 };
 
 class BinaryConjective : public BaseFormula
@@ -272,6 +268,7 @@ public:
 	virtual Formula absorbConstants();
 	virtual bool equalTo(const Formula & f) const;
 	virtual Formula instantiate(const Variable & v, const Term & t);
+	virtual Formula substituteAtom(const Formula & a, const Formula & c);
 };
 
 class Or : public BinaryConjective
@@ -285,6 +282,7 @@ public:
 	virtual Formula absorbConstants();
 	virtual bool equalTo(const Formula & f) const;
 	virtual Formula instantiate(const Variable & v, const Term & t);
+	virtual Formula substituteAtom(const Formula & a, const Formula & c);
 };
 
 class Imp : public BinaryConjective
@@ -298,6 +296,7 @@ public:
 	virtual Formula absorbConstants();
 	virtual bool equalTo(const Formula & f) const;
 	virtual Formula instantiate(const Variable & v, const Term & t);
+	virtual Formula substituteAtom(const Formula & a, const Formula & c);
 };
 
 class Iff : public BinaryConjective
@@ -311,6 +310,7 @@ public:
 	virtual Formula absorbConstants();
 	virtual bool equalTo(const Formula & f) const;
 	virtual Formula instantiate(const Variable & v, const Term & t);
+	virtual Formula substituteAtom(const Formula & a, const Formula & c);
 };
 
 class Quantifier : public BaseFormula
@@ -337,6 +337,7 @@ public:
 	virtual Formula releaseIff();
 	virtual Formula absorbConstants();
 	virtual Formula instantiate(const Variable & v, const Term & t);
+	virtual Formula substituteAtom(const Formula & a, const Formula & c);
 };
 
 class Exists : public Quantifier
@@ -350,11 +351,10 @@ public:
 	virtual Formula releaseIff();
 	virtual Formula absorbConstants();
 	virtual Formula instantiate(const Variable & v, const Term & t);
+	virtual Formula substituteAtom(const Formula & a, const Formula & c);
 };
 
 ostream & operator << (ostream & ostr, const Term & t);
 ostream & operator << (ostream & ostr, const Formula & f);
 
-extern Formula parsed_formula;
-
 #endif // _FOL_H
@@ -0,0 +1,107 @@
+#include "stdafx.h"
+#include "formulafeatures.h"
+
+#include <algorithm>
+
+// The kind of the last quantifier on the path, to count the alternations
+enum QuantifierKind { QK_NONE, QK_GAMMA, QK_DELTA, QK_BOTH };
+
+static void addTermFeatures(FormulaFeatures & features, const Term & t)
+{
+	features.size++;
+	if (t->getType() != BaseTerm::TT_FUNCTION)
+	{
+		return;
+	}
+
+	FunctionTerm * pFunction = (FunctionTerm *)t.get();
+	features.maxFunctionArity = max(features.maxFunctionArity, (unsigned)pFunction->getOperands().size());
+	for (const Term & operand : pFunction->getOperands())
+	{
+		addTermFeatures(features, operand);
+	}
+}
+
+/* A subformula of an equivalence has both signs, so polarity tells whether
+it is seen with the sign only (1), with its opposite only (-1) or with both (0). */
+static void addFormulaFeatures(FormulaFeatures & features, const Formula & f, int polarity, QuantifierKind last, unsigned alternations)
+{
+	features.size++;
+	switch (f->getType())
+	{
+		case BaseFormula::T_ATOM:
+		{
+			Atom * pAtom = (Atom *)f.get();
+			if (pAtom->getSymbol() == "=" || pAtom->getSymbol() == "~=")
+			{
+				features.hasEquality = true;
+			}
+			if (!pAtom->getOperands().empty())
+			{
+				features.propositional = false;
+			}
+			for (const Term & operand : pAtom->getOperands())
+			{
+				addTermFeatures(features, operand);
+			}
+			break;
+		}
+		case BaseFormula::T_NOT:
+			addFormulaFeatures(features, ((Not *)f.get())->getOperand(), -polarity, last, alternations);
+			break;
+		case BaseFormula::T_AND:
+		case BaseFormula::T_OR:
+		case BaseFormula::T_IMP:
+		{
+			BinaryConjective * pBinary = (BinaryConjective *)f.get();
+			int polarity1 = f->getType() == BaseFormula::T_IMP ? -polarity : polarity;
+			addFormulaFeatures(features, pBinary->getOperand1(), polarity1, last, alternations);
+			addFormulaFeatures(features, pBinary->getOperand2(), polarity, last, alternations);
+			break;
+		}
+		case BaseFormula::T_IFF:
+		{
+			BinaryConjective * pBinary = (BinaryConjective *)f.get();
+			features.iffCount++;
+			addFormulaFeatures(features, pBinary->getOperand1(), 0, last, alternations);
+			addFormulaFeatures(features, pBinary->getOperand2(), 0, last, alternations);
+			break;
+		}
+		case BaseFormula::T_FORALL:
+		case BaseFormula::T_EXISTS:
+		{
+			features.propositional = false;
+
+			// T ![X] and F ?[X] are gamma formulae, F ![X] and T ?[X] delta formulae
+			bool universal = f->getType() == BaseFormula::T_FORALL;
+			QuantifierKind kind = polarity == 0 ? QK_BOTH : (polarity > 0) == universal ? QK_GAMMA : QK_DELTA;
+			if (kind != QK_DELTA)
+			{
+				features.gammaPositions++;
+			}
+			if (kind != QK_GAMMA)
+			{
+				features.deltaPositions++;
+			}
+
+			// Under an equivalence the quantifier is both, which is a change in any case
+			if (last != QK_NONE && (kind != last || kind == QK_BOTH))
+			{
+				alternations++;
+			}
+			features.alternationDepth = max(features.alternationDepth, alternations);
+			addFormulaFeatures(features, ((Quantifier *)f.get())->getOperand(), polarity, kind, alternations);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+void FormulaFeatures::add(const Formula & f, bool sign)
+{
+	if (f.get() != 0)
+	{
+		addFormulaFeatures(*this, f, sign ? 1 : -1, QK_NONE, 0);
+	}
+}
@@ -0,0 +1,29 @@
+#ifndef _FORMULAFEATURES_H
+#define _FORMULAFEATURES_H
+
+#include "fol.hpp"
+
+/* Cheap syntactic features of formulas, gathered in one pass, from which a
+strategy is chosen before the proof. The positions are counted with the sign
+the formula has in the tableaux: a conjecture is signed F and a premise T. */
+struct FormulaFeatures
+{
+	// The number of formula and term nodes
+	unsigned size = 0;
+	// The largest number of changes between gamma and delta quantifiers on a path from the root
+	unsigned alternationDepth = 0;
+	// Quantifiers instantiated by the gamma rule, and those given a new constant by the delta rule
+	unsigned gammaPositions = 0;
+	unsigned deltaPositions = 0;
+	// The largest arity of a function symbol, 0 if there are only constants
+	unsigned maxFunctionArity = 0;
+	unsigned iffCount = 0;
+	bool hasEquality = false;
+	// No quantifiers and only propositional atoms
+	bool propositional = true;
+
+	/* Adds the features of the formula with the given sign. */
+	void add(const Formula & f, bool sign);
+};
+
+#endif // _FORMULAFEATURES_H
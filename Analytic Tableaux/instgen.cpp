@@ -0,0 +1,203 @@
+#include "stdafx.h"
+#include "instgen.h"
+#include "theory.h"
+
+#include <cstdlib>
+#include <sstream>
+
+// ----------------------------------------------------------------------------
+// InstGen
+
+InstGen::InstGen(const Formula & root, unsigned timeLimit)
+	:InstGen(Theory(), root, timeLimit)
+{}
+
+InstGen::InstGen(const Theory & premises, const Formula & conjecture, unsigned timeLimit, const CancellationToken & cancellation)
+	:_timeLimit(timeLimit), _cancellation(cancellation), _outOfTime(false), _rounds(0)
+{
+	_deadline = chrono::steady_clock::now() + chrono::milliseconds(timeLimit);
+
+	// The conjecture follows if and only if the clauses of the premises and of its negation are unsatisfiable
+	vector<Clause> clauses = premises.getClauses();
+	if (conjecture.get() != 0)
+	{
+		Clausifier clausifier = premises.getClausifier();
+		vector<Clause> negated = clausifier.clausifyNegation(conjecture);
+		clauses.insert(clauses.end(), negated.begin(), negated.end());
+	}
+	_hasEquality = containsEquality(clauses);
+
+	for (unsigned i = 0; i < clauses.size(); ++i)
+	{
+		addClause(renameClauseVariables(clauses[i], "X"));
+	}
+
+	_result = prove();
+}
+
+string InstGen::getResult() const
+{
+	// Without the axioms of equality, saturation says nothing about the models where = is equality
+	if (_outOfTime || (!_result && _hasEquality))
+	{
+		return "UNKNOWN";
+	}
+	return _result ? "TAUTOLOGY" : "NOT A TAUTOLOGY";
+}
+
+bool InstGen::isOutOfTime() const
+{
+	return _outOfTime;
+}
+
+unsigned InstGen::getRoundCount() const
+{
+	return _rounds;
+}
+
+unsigned InstGen::getClauseCount() const
+{
+	return _clauses.size();
+}
+
+bool InstGen::prove()
+{
+	while (true)
+	{
+		if ((_timeLimit != 0 && chrono::steady_clock::now() >= _deadline) || _cancellation.isCancelled())
+		{
+			_outOfTime = true;
+			return false;
+		}
+
+		// If even the propositional abstraction is unsatisfiable, then so are the clauses
+		_rounds++;
+		if (!_solver.solve())
+		{
+			return true;
+		}
+
+		// Select a literal that is true in the model in every clause, and index them by predicate and sign
+		unsigned clauseCount = _clauses.size();
+		vector<unsigned> selection(clauseCount);
+		map< pair<PredicateSymbol, bool>, vector<unsigned> > selectedIndex;
+
+		for (unsigned i = 0; i < clauseCount; ++i)
+		{
+			selection[i] = selectLiteral(_clauses[i]);
+			const Literal & l = _clauses[i][selection[i]];
+			selectedIndex[make_pair(((Atom *)l.atom.get())->getSymbol(), l.sign)].push_back(i);
+		}
+
+		// Instantiate both clauses of every unifiable complementary pair of selected literals
+		bool addedInstance = false;
+		for (unsigned i = 0; i < clauseCount; ++i)
+		{
+			Literal positive = _clauses[i][selection[i]];
+			if (!positive.sign)
+			{
+				continue;
+			}
+
+			const vector<unsigned> & negatives = selectedIndex[make_pair(((Atom *)positive.atom.get())->getSymbol(), false)];
+			for (unsigned j : negatives)
+			{
+				// Rename the variables of the other clause apart
+				Clause ci = _clauses[i];
+				Clause cj = renameClauseVariables(_clauses[j], "Y");
+
+				Substitution mgu;
+				if (!unifyAtoms(positive.atom, cj[selection[j]].atom, mgu))
+				{
+					continue;
+				}
+
+				if (addClause(renameClauseVariables(applySubstitution(ci, mgu), "X")))
+				{
+					addedInstance = true;
+				}
+				if (addClause(renameClauseVariables(applySubstitution(cj, mgu), "X")))
+				{
+					addedInstance = true;
+				}
+			}
+		}
+
+		// The model of the abstraction extends to a model of the clauses
+		if (!addedInstance)
+		{
+			return false;
+		}
+	}
+}
+
+bool InstGen::addClause(const Clause & c)
+{
+	// Variants of the clauses that are already there are not needed
+	if (!_clauseKeys.insert(getClauseKey(c)).second)
+	{
+		return false;
+	}
+
+	vector<SatLiteral> groundClause;
+	for (unsigned i = 0; i < c.size(); ++i)
+	{
+		groundClause.push_back(getGroundLiteral(c[i]));
+	}
+
+	_clauses.push_back(c);
+	_solver.addClause(groundClause);
+	return true;
+}
+
+SatLiteral InstGen::getGroundLiteral(const Literal & l)
+{
+	// Every variable is mapped to the same distinguished constant
+	deque<Variable> d_variables;
+	const vector<Term> & ops = ((Atom *)l.atom.get())->getOperands();
+	for (unsigned i = 0; i < ops.size(); ++i)
+	{
+		ops[i]->getVariables(d_variables);
+	}
+
+	Substitution bottom;
+	Term bottomConstant = make_shared<FunctionTerm>("$bot");
+	for (unsigned i = 0; i < d_variables.size(); ++i)
+	{
+		bottom[d_variables[i]] = bottomConstant;
+	}
+
+	ostringstream atomText;
+	applyRenaming(l.atom, bottom)->printFormula(atomText);
+
+	map<string, int>::const_iterator iter = _atomVariables.find(atomText.str());
+	int var;
+	if (iter != _atomVariables.cend())
+	{
+		var = iter->second;
+	}
+	else
+	{
+		var = _solver.newVariable();
+		_atomVariables[atomText.str()] = var;
+	}
+
+	return l.sign ? var : -var;
+}
+
+unsigned InstGen::selectLiteral(const Clause & c)
+{
+	for (unsigned i = 0; i < c.size(); ++i)
+	{
+		SatLiteral g = getGroundLiteral(c[i]);
+		if (_solver.getValue(abs(g)) == (g > 0))
+		{
+			return i;
+		}
+	}
+
+	throw "Not applicable: the model does not satisfy the clause abstraction";
+}
+
+// END InstGen
+// ----------------------------------------------------------------------------
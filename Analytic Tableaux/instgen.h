@@ -0,0 +1,61 @@
+#ifndef _INSTGEN_H
+#define _INSTGEN_H
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cancellation.h"
+#include "clause.h"
+#include "sat.h"
+
+class Theory;
+
+/* Instance-based (Inst-Gen) prover. The clauses of the negated formula are
+abstracted to propositional clauses by mapping every variable to the same
+constant, and the abstraction is solved by the SAT solver. Only the instances
+needed to block the unifiable complementary pairs of literals selected by the
+propositional model are generated.
+
+Equality is treated as an ordinary predicate, so a proof is still a proof,
+but clauses with equalities may have a model of the abstraction and no model
+in which = is equality; for them the result is UNKNOWN instead of NOT A
+TAUTOLOGY. */
+class InstGen
+{
+private:
+	vector<Clause> _clauses;
+	set<string> _clauseKeys;
+	map<string, int> _atomVariables;
+	SatSolver _solver;
+	unsigned _timeLimit;
+	chrono::steady_clock::time_point _deadline;
+	CancellationToken _cancellation;
+	bool _outOfTime;
+	bool _hasEquality;
+	unsigned _rounds;
+	bool _result;
+
+	bool prove();
+	bool addClause(const Clause & c);
+	SatLiteral getGroundLiteral(const Literal & l);
+	unsigned selectLiteral(const Clause & c);
+public:
+	// The result is UNKNOWN if the proof takes more milliseconds than the time limit, 0 means no limit
+	InstGen(const Formula & root, unsigned timeLimit = 0);
+	// Proves that the conjecture follows from the premises, or without a conjecture that they are unsatisfiable.
+	// The result is also UNKNOWN if the token is cancelled while the proof runs
+	InstGen(const Theory & premises, const Formula & conjecture, unsigned timeLimit = 0, const CancellationToken & cancellation = CancellationToken());
+
+	// TAUTOLOGY, NOT A TAUTOLOGY, or UNKNOWN if out of time or if there are equalities and no proof
+	string getResult() const;
+	// Whether the proof gave up because it was out of time or cancelled
+	bool isOutOfTime() const;
+	// The number of times the propositional abstraction was solved
+	unsigned getRoundCount() const;
+	unsigned getClauseCount() const;
+};
+
+#endif // _INSTGEN_H
@@ -0,0 +1,140 @@
+#include "stdafx.h"
+#include "libtableaux.h"
+#include "threadpool.h"
+
+#include <chrono>
+#include <functional>
+#include <sstream>
+
+static ProverStatus getStatus(const string & result)
+{
+	if (result == "TAUTOLOGY")
+	{
+		return PS_TAUTOLOGY;
+	}
+	else if (result == "NOT A TAUTOLOGY")
+	{
+		return PS_NOT_TAUTOLOGY;
+	}
+	return PS_UNKNOWN;
+}
+
+ProverResult proveFormula(const Formula & f, const ProverOptions & options)
+{
+	if (f.get() == 0)
+	{
+		ProverResult result;
+		result.error = "no formula";
+		return result;
+	}
+	return proveConjecture(Theory(), f, options);
+}
+
+ProverResult proveConjecture(const Theory & premises, const Formula & conjecture, const ProverOptions & options)
+{
+	ProverResult result;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	TableauxOptions tableauxOptions = options.tableaux;
+	ostringstream proof;
+	if (options.recordProof)
+	{
+		tableauxOptions.trace = true;
+		tableauxOptions.traceOutput = &proof;
+	}
+	ostringstream certificate;
+	if (options.recordCertificate)
+	{
+		tableauxOptions.certificateOutput = &certificate;
+	}
+
+	try
+	{
+		// The results of the engines are interpreted by the prover, as for the program
+		EngineReport report;
+		result.status = getStatus(proveConjecture(premises, conjecture, options.engine, tableauxOptions, &report));
+		result.limit = report.limit;
+		result.strategy = report.strategy;
+		result.counterModel = report.counterModel;
+		result.statistics.steps = report.steps;
+		result.statistics.closedBranches = report.closedBranches;
+		result.statistics.openBranches = report.openBranches;
+		result.statistics.clauses = report.clauses;
+		result.statistics.peakMemory = report.peakMemory;
+		result.proof = proof.str();
+		result.certificate = certificate.str();
+	}
+	catch (const char * message)
+	{
+		result.status = PS_ERROR;
+		result.error = message;
+	}
+	catch (const exception & e)
+	{
+		result.status = PS_ERROR;
+		result.error = e.what();
+	}
+
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+	result.statistics.milliseconds = elapsed.count();
+	return result;
+}
+
+/* Proves the formulas on options.threads threads with the given function. */
+static vector<ProverResult> proveAll(const vector<Formula> & formulas, const ProverOptions & options, const function<ProverResult(const Formula &)> & prove)
+{
+	vector<ProverResult> results(formulas.size());
+
+	if (options.threads <= 1)
+	{
+		for (unsigned i = 0; i < formulas.size(); i++)
+		{
+			results[i] = prove(formulas[i]);
+		}
+		return results;
+	}
+
+	// Every task writes only its own result, and the pool is done with all of them when it is destroyed
+	{
+		ThreadPool pool(options.threads);
+		for (unsigned i = 0; i < formulas.size(); i++)
+		{
+			pool.submit([&results, &formulas, &prove, i]
+			{
+				results[i] = prove(formulas[i]);
+			});
+		}
+	}
+	return results;
+}
+
+vector<ProverResult> proveFormulas(const vector<Formula> & formulas, const ProverOptions & options)
+{
+	return proveAll(formulas, options, [&options](const Formula & f)
+	{
+		return proveFormula(f, options);
+	});
+}
+
+vector<ProverResult> proveConjectures(const Theory & premises, const vector<Formula> & conjectures, const ProverOptions & options)
+{
+	return proveAll(conjectures, options, [&premises, &options](const Formula & f)
+	{
+		return proveConjecture(premises, f, options);
+	});
+}
+
+string getStatusName(ProverStatus status)
+{
+	switch (status)
+	{
+	case PS_TAUTOLOGY:
+		return "TAUTOLOGY";
+	case PS_NOT_TAUTOLOGY:
+		return "NOT A TAUTOLOGY";
+	case PS_UNKNOWN:
+		return "UNKNOWN";
+	default:
+		return "ERROR";
+	}
+}
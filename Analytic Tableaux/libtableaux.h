@@ -0,0 +1,98 @@
+#ifndef _LIBTABLEAUX_H
+#define _LIBTABLEAUX_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "fol.hpp"
+#include "prover.h"
+#include "tableaux.h"
+#include "theory.h"
+
+/* The interface of the prover library. Formulas are either parsed from
+text with parseFormula (prover.h), or built from the classes in fol.hpp, for example
+	Formula f = make_shared<Imp>(make_shared<Atom>("p"), make_shared<Atom>("p"));
+and then proved with the options below. Nothing is written to the standard
+output unless asked for, and no exception leaves these functions. */
+
+struct ProverOptions
+{
+	Engine engine = E_TABLEAUX;
+	// The heuristics, the time limit and the tracing of the tableaux, where
+	// the time limit and the relevance filtering are used by all engines
+	TableauxOptions tableaux;
+	// Keep the tableaux in the result (only for the tableaux engine)
+	bool recordProof = false;
+	// Keep the certificate of the proof in the result (only for the tableaux engine)
+	bool recordCertificate = false;
+	// The number of formulas proved at once by proveFormulas
+	unsigned threads = 1;
+
+	ProverOptions()
+	{
+		tableaux.trace = false;
+	}
+};
+
+enum ProverStatus
+{
+	PS_TAUTOLOGY,
+	PS_NOT_TAUTOLOGY,
+	PS_UNKNOWN,
+	PS_ERROR
+};
+
+struct ProverStatistics
+{
+	double milliseconds = 0;
+	// Rule applications of the tableaux, rounds of Inst-Gen or given clauses of resolution
+	unsigned steps = 0;
+	unsigned closedBranches = 0;
+	unsigned openBranches = 0;
+	// The clauses kept by Inst-Gen or resolution
+	unsigned clauses = 0;
+	// The most memory of the process seen by the tableaux, if it had a memory limit
+	size_t peakMemory = 0;
+};
+
+struct ProverResult
+{
+	ProverStatus status = PS_ERROR;
+	// Why the status is PS_ERROR
+	string error;
+	ProverStatistics statistics;
+	// The tableaux, if it was asked for
+	string proof;
+	// The certificate of the proof as CertificateWriter writes it, if it was asked for
+	string certificate;
+	// The strategy chosen for the engine E_AUTO
+	string strategy;
+	// Which limit made the status PS_UNKNOWN, as getLimitName gives it, or empty if none did
+	string limit;
+	// For PS_NOT_TAUTOLOGY from the tableaux, its open branch as Tableaux::getCounterModel gives it
+	string counterModel;
+};
+
+ProverResult proveFormula(const Formula & f, const ProverOptions & options = ProverOptions());
+
+/* Proves that the conjecture follows from the premises. The premises are
+prepared once when the theory is made, for example
+	Theory premises(axioms);
+and can then be used for any number of conjectures, also on several threads
+at once. Without a conjecture it is proved that the premises are unsatisfiable.
+If options.tableaux.relevanceDepth is set and some premises are not relevant
+to the conjecture, PS_UNKNOWN is given instead of PS_NOT_TAUTOLOGY. */
+ProverResult proveConjecture(const Theory & premises, const Formula & conjecture, const ProverOptions & options = ProverOptions());
+
+/* Proves the formulas on options.threads threads. The results are in
+the same order as the formulas. */
+vector<ProverResult> proveFormulas(const vector<Formula> & formulas, const ProverOptions & options = ProverOptions());
+
+/* Proves every conjecture from the premises on options.threads threads. */
+vector<ProverResult> proveConjectures(const Theory & premises, const vector<Formula> & conjectures, const ProverOptions & options = ProverOptions());
+
+/* TAUTOLOGY, NOT A TAUTOLOGY, UNKNOWN or ERROR, as printed by the program. */
+string getStatusName(ProverStatus status);
+
+#endif // _LIBTABLEAUX_H
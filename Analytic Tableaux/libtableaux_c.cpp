@@ -0,0 +1,355 @@
+#include "stdafx.h"
+#include "libtableaux_c.h"
+#include "libtableaux.h"
+#include "session.h"
+
+#include <cstring>
+#include <mutex>
+#include <new>
+
+struct at_prover
+{
+	ProverOptions options;
+	ProverResult result;
+	string error;
+	// Replaced after a cancelled proof, under the mutex as at_cancel reads it from other threads
+	mutex cancellationMutex;
+	CancellationToken cancellation;
+
+	at_prover()
+		:cancellation(CancellationToken::create())
+	{}
+};
+
+struct at_formula
+{
+	Formula formula;
+};
+
+struct at_session
+{
+	ProverSession session;
+
+	at_session(const TableauxOptions & options)
+		:session(options)
+	{}
+};
+
+static size_t copyString(const string & s, char * buffer, size_t size)
+{
+	if (buffer != 0 && size > 0)
+	{
+		size_t n = s.size() < size - 1 ? s.size() : size - 1;
+		memcpy(buffer, s.c_str(), n);
+		buffer[n] = '\0';
+	}
+	return s.size();
+}
+
+static int setFlag(bool & flag, int enabled)
+{
+	flag = enabled != 0;
+	return 0;
+}
+
+at_prover * at_prover_new(void)
+{
+	return new (nothrow) at_prover();
+}
+
+void at_prover_free(at_prover * prover)
+{
+	delete prover;
+}
+
+int at_set_engine(at_prover * prover, int engine)
+{
+	if (prover == 0 || engine < AT_ENGINE_TABLEAUX || engine > AT_ENGINE_AUTO)
+	{
+		return -1;
+	}
+	prover->options.engine = (Engine)engine;
+	return 0;
+}
+
+int at_set_time_limit(at_prover * prover, unsigned milliseconds)
+{
+	if (prover == 0)
+	{
+		return -1;
+	}
+	prover->options.tableaux.timeLimit = milliseconds;
+	return 0;
+}
+
+int at_set_rule_limit(at_prover * prover, unsigned rules)
+{
+	if (prover == 0)
+	{
+		return -1;
+	}
+	prover->options.tableaux.ruleLimit = rules;
+	return 0;
+}
+
+int at_set_memory_limit(at_prover * prover, size_t bytes)
+{
+	if (prover == 0)
+	{
+		return -1;
+	}
+	prover->options.tableaux.memoryLimit = bytes;
+	return 0;
+}
+
+int at_set_simplify(at_prover * prover, int enabled)
+{
+	return prover == 0 ? -1 : setFlag(prover->options.tableaux.simplifyBranches, enabled);
+}
+
+int at_set_lookahead(at_prover * prover, int enabled)
+{
+	if (prover == 0)
+	{
+		return -1;
+	}
+	prover->options.tableaux.betaSelection = enabled != 0 ? TableauxOptions::BS_LOOKAHEAD : TableauxOptions::BS_FIRST;
+	return 0;
+}
+
+int at_set_find_models(at_prover * prover, int enabled)
+{
+	return prover == 0 ? -1 : setFlag(prover->options.tableaux.findModels, enabled);
+}
+
+int at_set_record_proof(at_prover * prover, int enabled)
+{
+	return prover == 0 ? -1 : setFlag(prover->options.recordProof, enabled);
+}
+
+int at_set_record_certificate(at_prover * prover, int enabled)
+{
+	return prover == 0 ? -1 : setFlag(prover->options.recordCertificate, enabled);
+}
+
+at_formula * at_parse(at_prover * prover, const char * text)
+{
+	if (prover == 0 || text == 0)
+	{
+		return 0;
+	}
+
+	try
+	{
+		Formula f = parseFormula(text, prover->error);
+		if (f.get() == 0)
+		{
+			return 0;
+		}
+
+		at_formula * formula = new at_formula();
+		formula->formula = f;
+		return formula;
+	}
+	catch (...)
+	{
+		prover->error = "out of memory";
+		return 0;
+	}
+}
+
+void at_formula_free(at_formula * formula)
+{
+	delete formula;
+}
+
+int at_prove(at_prover * prover, const at_formula * formula)
+{
+	if (prover == 0)
+	{
+		return AT_ERROR;
+	}
+	if (formula == 0)
+	{
+		prover->error = "no formula";
+		return AT_ERROR;
+	}
+
+	{
+		lock_guard<mutex> lock(prover->cancellationMutex);
+		prover->options.tableaux.cancellation = prover->cancellation;
+	}
+
+	try
+	{
+		prover->result = proveFormula(formula->formula, prover->options);
+		prover->error = prover->result.error;
+	}
+	catch (...)
+	{
+		// proveFormula already turns the errors of the engines into results
+		prover->result = ProverResult();
+		prover->error = "out of memory";
+	}
+
+	lock_guard<mutex> lock(prover->cancellationMutex);
+	if (prover->cancellation.isCancelled())
+	{
+		// The cancel is used up, the next proof runs again
+		prover->cancellation = CancellationToken::create();
+	}
+
+	// The enumerations have the same order
+	return (int)prover->result.status;
+}
+
+int at_prove_string(at_prover * prover, const char * text)
+{
+	at_formula * formula = at_parse(prover, text);
+	if (formula == 0)
+	{
+		if (prover != 0)
+		{
+			prover->result = ProverResult();
+		}
+		return AT_ERROR;
+	}
+
+	int status = at_prove(prover, formula);
+	at_formula_free(formula);
+	return status;
+}
+
+int at_cancel(at_prover * prover)
+{
+	if (prover == 0)
+	{
+		return -1;
+	}
+
+	lock_guard<mutex> lock(prover->cancellationMutex);
+	prover->cancellation.cancel();
+	return 0;
+}
+
+void at_get_statistics(const at_prover * prover, struct at_statistics * statistics)
+{
+	if (prover == 0 || statistics == 0)
+	{
+		return;
+	}
+
+	const ProverStatistics & s = prover->result.statistics;
+	statistics->milliseconds = s.milliseconds;
+	statistics->steps = s.steps;
+	statistics->closed_branches = s.closedBranches;
+	statistics->open_branches = s.openBranches;
+	statistics->clauses = s.clauses;
+}
+
+size_t at_get_proof(const at_prover * prover, char * buffer, size_t size)
+{
+	return prover == 0 ? copyString(string(), buffer, size) : copyString(prover->result.proof, buffer, size);
+}
+
+size_t at_get_certificate(const at_prover * prover, char * buffer, size_t size)
+{
+	return prover == 0 ? copyString(string(), buffer, size) : copyString(prover->result.certificate, buffer, size);
+}
+
+size_t at_get_counter_model(const at_prover * prover, char * buffer, size_t size)
+{
+	return prover == 0 ? copyString(string(), buffer, size) : copyString(prover->result.counterModel, buffer, size);
+}
+
+size_t at_last_error(const at_prover * prover, char * buffer, size_t size)
+{
+	return prover == 0 ? copyString(string(), buffer, size) : copyString(prover->error, buffer, size);
+}
+
+at_session * at_session_new(const at_prover * prover)
+{
+	if (prover == 0)
+	{
+		return 0;
+	}
+
+	// The session never records its tableaux
+	TableauxOptions options = prover->options.tableaux;
+	options.trace = false;
+	// The token of the last proof may be cancelled
+	options.cancellation = CancellationToken();
+	return new (nothrow) at_session(options);
+}
+
+void at_session_free(at_session * session)
+{
+	delete session;
+}
+
+int at_assert(at_session * session, const at_formula * formula)
+{
+	if (session == 0 || formula == 0)
+	{
+		return -1;
+	}
+
+	try
+	{
+		session->session.assertFormula(formula->formula);
+	}
+	catch (...)
+	{
+		return -1;
+	}
+	return 0;
+}
+
+int at_push(at_session * session)
+{
+	if (session == 0)
+	{
+		return -1;
+	}
+
+	try
+	{
+		session->session.push();
+	}
+	catch (...)
+	{
+		return -1;
+	}
+	return 0;
+}
+
+int at_pop(at_session * session)
+{
+	return session != 0 && session->session.pop() ? 0 : -1;
+}
+
+int at_check(at_session * session, const at_formula * conjecture)
+{
+	if (session == 0)
+	{
+		return AT_ERROR;
+	}
+
+	try
+	{
+		string result = session->session.check(conjecture != 0 ? conjecture->formula : Formula());
+
+		// The session gives the result by its name, as the engines do
+		for (int status = AT_TAUTOLOGY; status < AT_ERROR; status++)
+		{
+			if (getStatusName((ProverStatus)status) == result)
+			{
+				return status;
+			}
+		}
+	}
+	catch (...)
+	{
+	}
+	return AT_ERROR;
+}
@@ -0,0 +1,128 @@
+#ifndef _LIBTABLEAUX_C_H
+#define _LIBTABLEAUX_C_H
+
+/* The C interface of the prover library, for callers that are not C++.
+
+All objects are used through opaque handles. A prover handle keeps the
+options, the result of the last proof and the last error; it must not be
+used by two threads at once, but every thread can have its own. Only
+at_cancel may be called while another thread uses the prover. Strings are
+copied into buffers given by the caller: the functions return the length of
+the whole string, and write at most size - 1 characters and a '\0'. No
+exception leaves these functions; errors are reported by the return values
+and at_last_error. */
+
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(AT_SHARED)
+#ifdef AT_BUILD
+#define AT_API __declspec(dllexport)
+#else
+#define AT_API __declspec(dllimport)
+#endif
+#else
+#define AT_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct at_prover at_prover;
+typedef struct at_formula at_formula;
+typedef struct at_session at_session;
+
+/* The values are part of the interface and do not change. */
+enum at_status
+{
+	AT_TAUTOLOGY = 0,
+	AT_NOT_TAUTOLOGY = 1,
+	AT_UNKNOWN = 2,
+	AT_ERROR = 3
+};
+
+enum at_engine
+{
+	AT_ENGINE_TABLEAUX = 0,
+	AT_ENGINE_INSTGEN = 1,
+	AT_ENGINE_RESOLUTION = 2,
+	// Chosen for each formula from its features
+	AT_ENGINE_AUTO = 3
+};
+
+struct at_statistics
+{
+	double milliseconds;
+	unsigned steps;
+	unsigned closed_branches;
+	unsigned open_branches;
+	unsigned clauses;
+};
+
+/* Returns 0 if there is not enough memory. */
+AT_API at_prover * at_prover_new(void);
+AT_API void at_prover_free(at_prover * prover);
+
+/* The setters return 0 on success and -1 for a wrong value. */
+AT_API int at_set_engine(at_prover * prover, int engine);
+AT_API int at_set_time_limit(at_prover * prover, unsigned milliseconds);
+/* The limits of the tableaux engine: rule applications, and bytes of memory
+of the whole process. 0 means no limit. */
+AT_API int at_set_rule_limit(at_prover * prover, unsigned rules);
+AT_API int at_set_memory_limit(at_prover * prover, size_t bytes);
+AT_API int at_set_simplify(at_prover * prover, int enabled);
+AT_API int at_set_lookahead(at_prover * prover, int enabled);
+/* Look for a finite counter-model on another thread while the tableaux engine
+runs; a model found first gives AT_NOT_TAUTOLOGY. */
+AT_API int at_set_find_models(at_prover * prover, int enabled);
+AT_API int at_set_record_proof(at_prover * prover, int enabled);
+AT_API int at_set_record_certificate(at_prover * prover, int enabled);
+
+/* Parses a formula, with or without its terminating ';'. Returns 0 and
+sets the last error if the text is not a correct formula. The formula does
+not belong to the prover and can be used with any of them. */
+AT_API at_formula * at_parse(at_prover * prover, const char * text);
+AT_API void at_formula_free(at_formula * formula);
+
+/* Prove a formula and return its at_status. */
+AT_API int at_prove(at_prover * prover, const at_formula * formula);
+AT_API int at_prove_string(at_prover * prover, const char * text);
+
+/* Asks the running proof of the prover to give up soon, and then it returns
+AT_UNKNOWN. It can be called from any thread; if no proof is running, the
+next one is cancelled. The sessions made from the prover are not cancelled.
+Returns 0, or -1 without a prover. */
+AT_API int at_cancel(at_prover * prover);
+
+/* About the last proof of the prover. */
+AT_API void at_get_statistics(const at_prover * prover, struct at_statistics * statistics);
+AT_API size_t at_get_proof(const at_prover * prover, char * buffer, size_t size);
+/* The certificate of the last proof of the tableaux engine, one line for every
+rule application, if at_set_record_certificate was set. */
+AT_API size_t at_get_certificate(const at_prover * prover, char * buffer, size_t size);
+/* The counter-model read off the open branch when the tableaux engine gave
+AT_NOT_TAUTOLOGY, for example "{a, c} b = a, p(a), ~q(c)": the constants which
+stand for the elements, the other terms of the branch equal to them, and the
+atoms of the branch over those elements, true or false with '~'. An atom is
+true only if it is congruent to a true one. */
+AT_API size_t at_get_counter_model(const at_prover * prover, char * buffer, size_t size);
+AT_API size_t at_last_error(const at_prover * prover, char * buffer, size_t size);
+
+/* An incremental session of the tableaux engine, with the tableaux options
+the prover has when it is made. Formulas are asserted, and at_push and at_pop
+mark and retract a group of assertions. at_check returns the at_status of
+proving the conjecture from the assertions, or without a conjecture (0) of
+proving that the assertions are unsatisfiable. The other functions return 0
+on success and -1 on an error, such as at_pop without an at_push. */
+AT_API at_session * at_session_new(const at_prover * prover);
+AT_API void at_session_free(at_session * session);
+AT_API int at_assert(at_session * session, const at_formula * formula);
+AT_API int at_push(at_session * session);
+AT_API int at_pop(at_session * session);
+AT_API int at_check(at_session * session, const at_formula * conjecture);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _LIBTABLEAUX_C_H
@@ -0,0 +1,150 @@
+#include "stdafx.h"
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// MappedFile
+
+MappedFile::MappedFile()
+	:_data(0), _size(0), _file(0), _mapping(0)
+{}
+
+const char * MappedFile::getData() const
+{
+	return _data;
+}
+
+size_t MappedFile::getSize() const
+{
+	return _size;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const string & path)
+{
+	close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		close();
+		return false;
+	}
+
+	// An empty file cannot be mapped, but there is nothing to read from it anyway
+	_size = (size_t)size.QuadPart;
+	if (_size == 0)
+	{
+		return true;
+	}
+
+	_mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+	if (_mapping == 0)
+	{
+		close();
+		return false;
+	}
+
+	_data = (const char *)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (_data == 0)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (_data != 0)
+	{
+		UnmapViewOfFile(_data);
+	}
+	if (_mapping != 0)
+	{
+		CloseHandle(_mapping);
+	}
+	if (_file != 0)
+	{
+		CloseHandle(_file);
+	}
+	_data = 0;
+	_size = 0;
+	_file = 0;
+	_mapping = 0;
+}
+
+#else
+
+bool MappedFile::open(const string & path)
+{
+	close();
+
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(file, &status) != 0)
+	{
+		::close(file);
+		return false;
+	}
+
+	// An empty file cannot be mapped, but there is nothing to read from it anyway
+	_size = (size_t)status.st_size;
+	if (_size > 0)
+	{
+		void * data = mmap(0, _size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data == MAP_FAILED)
+		{
+			::close(file);
+			_size = 0;
+			return false;
+		}
+		madvise(data, _size, MADV_SEQUENTIAL);
+		_data = (const char *)data;
+	}
+
+	// The mapping stays valid without the descriptor
+	::close(file);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (_data != 0)
+	{
+		munmap((void *)_data, _size);
+	}
+	_data = 0;
+	_size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+// END MappedFile
+// ----------------------------------------------------------------------------
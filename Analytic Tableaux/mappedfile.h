@@ -0,0 +1,34 @@
+#ifndef _MAPPEDFILE_H
+#define _MAPPEDFILE_H
+
+#include <string>
+
+using namespace std;
+
+/* A file mapped read-only into memory, so that it can be parsed in place
+without reading it into a buffer. The pages are loaded by the system as
+they are read and can be dropped again, so even files larger than the
+memory can be used. */
+class MappedFile
+{
+private:
+	const char * _data;
+	size_t _size;
+	// The handles of the file and of its mapping, as the system gives them
+	void * _file;
+	void * _mapping;
+
+	void close();
+public:
+	MappedFile();
+
+	/* Maps the whole file. Returns false if the file cannot be opened or mapped. */
+	bool open(const string & path);
+
+	const char * getData() const;
+	size_t getSize() const;
+
+	~MappedFile();
+};
+
+#endif // _MAPPEDFILE_H
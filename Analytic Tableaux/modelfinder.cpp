@@ -0,0 +1,393 @@
+#include "stdafx.h"
+#include "modelfinder.h"
+
+#include <cmath>
+#include <sstream>
+
+// The search stops before a domain size whose ground clauses would be more than this
+static const double MAX_GROUND_CLAUSES = 2000000;
+// The token is polled after this many ground clauses, while they are made
+static const unsigned CANCELLATION_CHECK_INTERVAL = 1024;
+
+// The index of the tuple of domain elements, read as a number in base size
+static unsigned getTupleIndex(const vector<unsigned> & values, const vector<unsigned> & variables, unsigned count, unsigned size)
+{
+	unsigned index = 0;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		index = index * size + values[variables[i]];
+	}
+	return index;
+}
+
+// Steps the tuple to the next one in base size; returns false after the last one
+static bool nextTuple(vector<unsigned> & tuple, unsigned size)
+{
+	for (unsigned i = tuple.size(); i > 0; --i)
+	{
+		if (++tuple[i - 1] < size)
+		{
+			return true;
+		}
+		tuple[i - 1] = 0;
+	}
+	return false;
+}
+
+static void printTuple(ostream & ostr, const string & name, const vector<unsigned> & tuple)
+{
+	ostr << name;
+	for (unsigned i = 0; i < tuple.size(); ++i)
+	{
+		ostr << (i == 0 ? "(" : ",") << tuple[i];
+	}
+	if (!tuple.empty())
+	{
+		ostr << ")";
+	}
+}
+
+// ----------------------------------------------------------------------------
+// ModelFinder
+
+ModelFinder::ModelFinder(const vector<Clause> & clauses, const CancellationToken & cancellation)
+	:_cancellation(cancellation), _hasEmptyClause(false), _size(0), _found(false)
+{
+	for (const Clause & c : clauses)
+	{
+		flattenClause(c);
+	}
+
+	// The empty clause has no model of any size
+	if (_hasEmptyClause)
+	{
+		return;
+	}
+
+	for (unsigned size = 1; !_cancellation.isCancelled() && countInstances(size) <= MAX_GROUND_CLAUSES; ++size)
+	{
+		_size = size;
+		if (findModel(size))
+		{
+			_found = true;
+			return;
+		}
+	}
+}
+
+bool ModelFinder::isFound() const
+{
+	return _found;
+}
+
+unsigned ModelFinder::getSize() const
+{
+	return _size;
+}
+
+string ModelFinder::getModel() const
+{
+	if (!_found)
+	{
+		return "";
+	}
+
+	ostringstream model;
+	model << "{";
+	for (unsigned i = 0; i < _size; ++i)
+	{
+		model << (i == 0 ? "" : ", ") << i;
+	}
+	model << "}";
+
+	bool first = true;
+	for (const Symbol & symbol : _symbols)
+	{
+		vector<unsigned> tuple(symbol.arity, 0);
+		int var = symbol.firstVariable;
+		do
+		{
+			model << (first ? " " : ", ");
+			first = false;
+
+			if (symbol.function)
+			{
+				// Exactly one of the values is true
+				unsigned value = 0;
+				for (unsigned v = 0; v < _size; ++v, ++var)
+				{
+					if (_values[var - 1])
+					{
+						value = v;
+					}
+				}
+				printTuple(model, symbol.name, tuple);
+				model << " = " << value;
+			}
+			else
+			{
+				model << (_values[var - 1] ? "" : "~");
+				printTuple(model, symbol.name, tuple);
+				++var;
+			}
+		} while (nextTuple(tuple, _size));
+	}
+	return model.str();
+}
+
+unsigned ModelFinder::getSymbol(const string & name, unsigned arity, bool function)
+{
+	string key = (function ? "f " : "p ") + name + "/" + to_string(arity);
+	map<string, unsigned>::const_iterator iter = _symbolIndexes.find(key);
+	if (iter != _symbolIndexes.end())
+	{
+		return iter->second;
+	}
+
+	Symbol symbol;
+	symbol.name = name;
+	symbol.arity = arity;
+	symbol.function = function;
+	symbol.firstVariable = 0;
+	_symbols.push_back(symbol);
+	_symbolIndexes[key] = _symbols.size() - 1;
+	return _symbols.size() - 1;
+}
+
+void ModelFinder::flattenClause(const Clause & c)
+{
+	if (c.empty())
+	{
+		_hasEmptyClause = true;
+		return;
+	}
+
+	FlatClause flat;
+	flat.variableCount = 0;
+	map<Variable, unsigned> variables;
+
+	for (const Literal & l : c)
+	{
+		const Atom * pAtom = (const Atom *)l.atom.get();
+		const vector<Term> & ops = pAtom->getOperands();
+
+		FlatLiteral literal;
+		literal.sign = l.sign;
+		literal.symbol = 0;
+
+		if (pAtom->getSymbol() == "=" && ops.size() == 2)
+		{
+			// f(...) = Y is a literal of its own, any other equality is between the variables of its sides
+			unsigned functionSide = 2;
+			if (ops[0]->getType() == BaseTerm::TT_FUNCTION && ops[1]->getType() == BaseTerm::TT_VARIABLE)
+			{
+				functionSide = 0;
+			}
+			else if (ops[1]->getType() == BaseTerm::TT_FUNCTION && ops[0]->getType() == BaseTerm::TT_VARIABLE)
+			{
+				functionSide = 1;
+			}
+
+			if (functionSide < 2)
+			{
+				const FunctionTerm * pFunction = (const FunctionTerm *)ops[functionSide].get();
+				literal.kind = LK_FUNCTION;
+				literal.symbol = getSymbol(pFunction->getSymbol(), pFunction->getOperands().size(), true);
+				flattenArguments(pFunction->getOperands(), variables, flat, literal.variables);
+				literal.variables.push_back(flattenTerm(ops[1 - functionSide], variables, flat));
+			}
+			else
+			{
+				literal.kind = LK_EQUALITY;
+				literal.variables.push_back(flattenTerm(ops[0], variables, flat));
+				literal.variables.push_back(flattenTerm(ops[1], variables, flat));
+			}
+		}
+		else
+		{
+			literal.kind = LK_PREDICATE;
+			literal.symbol = getSymbol(pAtom->getSymbol(), ops.size(), false);
+			flattenArguments(ops, variables, flat, literal.variables);
+		}
+		flat.literals.push_back(literal);
+	}
+
+	flat.variableCount = variables.size();
+	_clauses.push_back(flat);
+}
+
+void ModelFinder::flattenArguments(const vector<Term> & ops, map<Variable, unsigned> & variables, FlatClause & flat, vector<unsigned> & arguments)
+{
+	for (const Term & op : ops)
+	{
+		arguments.push_back(flattenTerm(op, variables, flat));
+	}
+}
+
+// Gives the variable which stands for the term; a function application f(...) becomes a new variable Y with f(...) != Y in the clause
+unsigned ModelFinder::flattenTerm(const Term & t, map<Variable, unsigned> & variables, FlatClause & flat)
+{
+	if (t->getType() == BaseTerm::TT_VARIABLE)
+	{
+		const Variable & v = ((const VariableTerm *)t.get())->getVariable();
+		map<Variable, unsigned>::const_iterator iter = variables.find(v);
+		if (iter != variables.end())
+		{
+			return iter->second;
+		}
+
+		unsigned index = variables.size();
+		variables[v] = index;
+		return index;
+	}
+
+	const FunctionTerm * pFunction = (const FunctionTerm *)t.get();
+	FlatLiteral literal;
+	literal.kind = LK_FUNCTION;
+	literal.sign = false;
+	literal.symbol = getSymbol(pFunction->getSymbol(), pFunction->getOperands().size(), true);
+	flattenArguments(pFunction->getOperands(), variables, flat, literal.variables);
+
+	// The new variables are named so that they cannot clash with those of the clause
+	unsigned result = variables.size();
+	variables["#" + to_string(result)] = result;
+	literal.variables.push_back(result);
+	flat.literals.push_back(literal);
+	return result;
+}
+
+double ModelFinder::countInstances(unsigned size) const
+{
+	double count = 0;
+	for (const FlatClause & c : _clauses)
+	{
+		count += pow((double)size, (double)c.variableCount);
+	}
+	for (const Symbol & symbol : _symbols)
+	{
+		if (symbol.function)
+		{
+			count += pow((double)size, (double)symbol.arity) * (1 + size * (size - 1) / 2.0);
+		}
+	}
+	return count;
+}
+
+SatLiteral ModelFinder::getLiteral(const FlatLiteral & l, const vector<unsigned> & values, unsigned size) const
+{
+	const Symbol & symbol = _symbols[l.symbol];
+	int var;
+	if (l.kind == LK_FUNCTION)
+	{
+		unsigned tuple = getTupleIndex(values, l.variables, symbol.arity, size);
+		var = symbol.firstVariable + tuple * size + values[l.variables[symbol.arity]];
+	}
+	else
+	{
+		var = symbol.firstVariable + getTupleIndex(values, l.variables, symbol.arity, size);
+	}
+	return l.sign ? var : -var;
+}
+
+bool ModelFinder::findModel(unsigned size)
+{
+	SatSolver solver;
+
+	// A predicate has a variable for every tuple, a function for every tuple and value
+	for (Symbol & symbol : _symbols)
+	{
+		unsigned count = (unsigned)pow((double)size, (double)symbol.arity) * (symbol.function ? size : 1);
+		symbol.firstVariable = solver.getVariableCount() + 1;
+		for (unsigned i = 0; i < count; ++i)
+		{
+			solver.newVariable();
+		}
+	}
+
+	// Every function has exactly one value for every tuple
+	unsigned constants = 0;
+	for (const Symbol & symbol : _symbols)
+	{
+		if (!symbol.function)
+		{
+			continue;
+		}
+
+		unsigned tuples = (unsigned)pow((double)size, (double)symbol.arity);
+		for (unsigned tuple = 0; tuple < tuples; ++tuple)
+		{
+			int first = symbol.firstVariable + tuple * size;
+			vector<SatLiteral> some;
+			for (unsigned v = 0; v < size; ++v)
+			{
+				some.push_back(first + v);
+				for (unsigned w = v + 1; w < size; ++w)
+				{
+					solver.addClause({ -(first + (int)v), -(first + (int)w) });
+				}
+			}
+			solver.addClause(some);
+		}
+
+		// Breaks the symmetries of the domain: the i-th constant is one of 0, ..., i
+		if (symbol.arity == 0)
+		{
+			for (unsigned v = constants + 1; v < size; ++v)
+			{
+				solver.addClause({ -(symbol.firstVariable + (int)v) });
+			}
+			constants++;
+		}
+	}
+
+	// All the instances of the flat clauses over the domain
+	unsigned instances = 0;
+	for (const FlatClause & c : _clauses)
+	{
+		vector<unsigned> values(c.variableCount, 0);
+		do
+		{
+			if (++instances % CANCELLATION_CHECK_INTERVAL == 0 && _cancellation.isCancelled())
+			{
+				return false;
+			}
+
+			vector<SatLiteral> ground;
+			bool satisfied = false;
+			for (const FlatLiteral & l : c.literals)
+			{
+				if (l.kind == LK_EQUALITY)
+				{
+					// Equal variables are the same element, so the literal is already true or false
+					if ((values[l.variables[0]] == values[l.variables[1]]) == l.sign)
+					{
+						satisfied = true;
+						break;
+					}
+					continue;
+				}
+				ground.push_back(getLiteral(l, values, size));
+			}
+
+			if (!satisfied)
+			{
+				solver.addClause(ground);
+			}
+		} while (nextTuple(values, size));
+	}
+
+	if (!solver.solve(_cancellation))
+	{
+		return false;
+	}
+
+	_values.assign(solver.getVariableCount(), false);
+	for (unsigned var = 1; var <= solver.getVariableCount(); ++var)
+	{
+		_values[var - 1] = solver.getValue(var);
+	}
+	return true;
+}
+
+// END ModelFinder
+// ----------------------------------------------------------------------------
@@ -0,0 +1,91 @@
+#ifndef _MODELFINDER_H
+#define _MODELFINDER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cancellation.h"
+#include "clause.h"
+#include "sat.h"
+
+/* A finder of finite models in the style of MACE. The clauses are flattened,
+so that every function application is a literal f(X1,...,Xk) = Y over
+variables, and then for the domain sizes 1, 2, 3, ... all their instances
+over the domain {0, ..., n - 1} are given to the SAT solver, together with
+the clauses which make every function total and single-valued. A model of
+these is a finite model of the clauses. The i-th constant is only given the
+values up to i, as any model has an isomorphic one where that holds.
+
+Clauses without a finite model are never refuted, so the search goes on
+until the token is cancelled or the instances for the next size would be
+too many. */
+class ModelFinder
+{
+private:
+	enum LiteralKind
+	{
+		// p(X1,...,Xk)
+		LK_PREDICATE,
+		// f(X1,...,Xk) = Y, with Y the last variable
+		LK_FUNCTION,
+		// X = Y
+		LK_EQUALITY
+	};
+
+	struct FlatLiteral
+	{
+		LiteralKind kind;
+		bool sign;
+		unsigned symbol;
+		vector<unsigned> variables;
+	};
+
+	struct FlatClause
+	{
+		unsigned variableCount;
+		vector<FlatLiteral> literals;
+	};
+
+	struct Symbol
+	{
+		string name;
+		unsigned arity;
+		bool function;
+		// The SAT variable of the first tuple, for the current domain size
+		int firstVariable;
+	};
+
+	vector<FlatClause> _clauses;
+	vector<Symbol> _symbols;
+	map<string, unsigned> _symbolIndexes;
+	CancellationToken _cancellation;
+	bool _hasEmptyClause;
+	unsigned _size;
+	bool _found;
+	// The values of the SAT variables in the model, by variable - 1
+	vector<bool> _values;
+
+	unsigned getSymbol(const string & name, unsigned arity, bool function);
+	void flattenClause(const Clause & c);
+	unsigned flattenTerm(const Term & t, map<Variable, unsigned> & variables, FlatClause & flat);
+	void flattenArguments(const vector<Term> & ops, map<Variable, unsigned> & variables, FlatClause & flat, vector<unsigned> & arguments);
+
+	double countInstances(unsigned size) const;
+	bool findModel(unsigned size);
+	SatLiteral getLiteral(const FlatLiteral & l, const vector<unsigned> & values, unsigned size) const;
+public:
+	ModelFinder(const vector<Clause> & clauses, const CancellationToken & cancellation = CancellationToken());
+
+	bool isFound() const;
+	// The domain size of the model, or of the last size tried if none was found
+	unsigned getSize() const;
+	/* Gives the model as
+		{0, 1} a = 0, f(0) = 1, f(1) = 0, p(0), ~p(1)
+	with the domain, the values of all the functions and the predicates,
+	where a false atom is written with '~'; or an empty string if no model
+	was found. */
+	string getModel() const;
+};
+
+#endif // _MODELFINDER_H
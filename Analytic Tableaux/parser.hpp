@@ -1,21 +1,22 @@
-/* A Bison parser, made by GNU Bison 2.7.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
-   
-      Copyright (C) 1984, 1989-1990, 2000-2012 Free Software Foundation, Inc.
-   
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
    the Free Software Foundation, either version 3 of the License, or
    (at your option) any later version.
-   
+
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
    GNU General Public License for more details.
-   
+
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -26,77 +27,94 @@
    special exception, which will cause the skeleton and the resulting
    Bison output files to be licensed under the GNU General Public
    License without this special exception.
-   
+
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 #ifndef YY_YY_PARSER_HPP_INCLUDED
 # define YY_YY_PARSER_HPP_INCLUDED
-/* Enabling traces.  */
+/* Debug traces.  */
 #ifndef YYDEBUG
 # define YYDEBUG 0
 #endif
 #if YYDEBUG
 extern int yydebug;
 #endif
+/* "%code requires" blocks.  */
+#line 10 "parser.ypp"
+
+#include "fol.hpp"
+
+typedef void * yyscan_t;
+
+#line 55 "parser.hpp"
 
-/* Tokens.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     SYMBOL = 258,
-     VARIABLE = 259,
-     TRUE = 260,
-     FALSE = 261,
-     NOT = 262,
-     AND = 263,
-     OR = 264,
-     IMP = 265,
-     IFF = 266,
-     EQ = 267,
-     NEQ = 268,
-     FORALL = 269,
-     EXISTS = 270
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    SYMBOL = 258,                  /* SYMBOL  */
+    VARIABLE = 259,                /* VARIABLE  */
+    TRUE = 260,                    /* TRUE  */
+    FALSE = 261,                   /* FALSE  */
+    NOT = 262,                     /* NOT  */
+    AND = 263,                     /* AND  */
+    OR = 264,                      /* OR  */
+    IMP = 265,                     /* IMP  */
+    IFF = 266,                     /* IFF  */
+    EQ = 267,                      /* EQ  */
+    NEQ = 268,                     /* NEQ  */
+    FORALL = 269,                  /* FORALL  */
+    EXISTS = 270                   /* EXISTS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
-
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
+union YYSTYPE
 {
-/* Line 2058 of yacc.c  */
-#line 41 "parser.ypp"
+#line 35 "parser.ypp"
 
   string * str_attr;
   BaseFormula * formula_attr;
   BaseTerm * term_attr;
   vector<Term> * term_seq_attr;
 
+#line 94 "parser.hpp"
 
-/* Line 2058 of yacc.c  */
-#line 80 "parser.hpp"
-} YYSTYPE;
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
 # define YYSTYPE_IS_DECLARED 1
 #endif
 
-extern YYSTYPE yylval;
 
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
+
+
+int yyparse (yyscan_t scanner, Formula & result, string & error);
+
+/* "%code provides" blocks.  */
+#line 16 "parser.ypp"
+
+int yylex(YYSTYPE * yylval_param, yyscan_t yyscanner);
+
+/* Parses one formula terminated by ';' from the buffer. Returns an empty
+formula and sets the error if the buffer does not hold a correct formula.
+Every call has its own scanner, so formulas can be parsed on several threads.
+The program reads its input with the Pratt parser; --selftest compares the
+two on random input. */
+Formula parseFormulaBuffer(const char * buffer, size_t length, string & error);
+
+#line 117 "parser.hpp"
 
 #endif /* !YY_YY_PARSER_HPP_INCLUDED  */
@@ -0,0 +1,149 @@
+#include "stdafx.h"
+#include "portfolio.h"
+
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// How the "+relevance" strategies select their premises
+static const unsigned PORTFOLIO_RELEVANCE_DEPTH = 3;
+static const double PORTFOLIO_RELEVANCE_TOLERANCE = 1.5;
+
+vector<PortfolioStrategy> getDefaultPortfolio()
+{
+	vector<PortfolioStrategy> strategies;
+	parsePortfolio("tableaux,tableaux+lookahead+simplify,instgen,resolution,resolution+relevance", strategies);
+	return strategies;
+}
+
+bool parsePortfolio(const string & text, vector<PortfolioStrategy> & strategies)
+{
+	strategies.clear();
+	istringstream input(text);
+	string item;
+	while (getline(input, item, ','))
+	{
+		PortfolioStrategy strategy;
+		strategy.name = item;
+
+		size_t colon = item.find(':');
+		if (colon != string::npos)
+		{
+			int n = atoi(item.c_str() + colon + 1);
+			if (n <= 0)
+			{
+				return false;
+			}
+			strategy.timeSlice = n;
+			item.erase(colon);
+		}
+
+		istringstream parts(item);
+		string part;
+		getline(parts, part, '+');
+		if (!parseEngine(part, strategy.engine))
+		{
+			return false;
+		}
+		while (getline(parts, part, '+'))
+		{
+			if (part == "simplify")
+			{
+				strategy.options.simplifyBranches = true;
+			}
+			else if (part == "lookahead")
+			{
+				strategy.options.betaSelection = TableauxOptions::BS_LOOKAHEAD;
+			}
+			else if (part == "models")
+			{
+				strategy.options.findModels = true;
+			}
+			else if (part == "relevance")
+			{
+				strategy.options.relevanceDepth = PORTFOLIO_RELEVANCE_DEPTH;
+				strategy.options.relevanceTolerance = PORTFOLIO_RELEVANCE_TOLERANCE;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		strategies.push_back(strategy);
+	}
+	return !strategies.empty();
+}
+
+PortfolioResult provePortfolio(const Theory & premises, const Formula & conjecture, const vector<PortfolioStrategy> & strategies, unsigned timeLimit)
+{
+	PortfolioResult portfolio;
+	portfolio.runs.resize(strategies.size());
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	// The winner cancels the token of all the strategies
+	CancellationToken cancellation = CancellationToken::create();
+	mutex winnerMutex;
+
+	vector<thread> threads;
+	for (unsigned i = 0; i < strategies.size(); i++)
+	{
+		threads.push_back(thread([&, i]
+		{
+			const PortfolioStrategy & strategy = strategies[i];
+			TableauxOptions options = strategy.options;
+			options.trace = false;
+			options.cancellation = cancellation;
+			options.timeLimit = strategy.timeSlice;
+			if (timeLimit != 0 && (options.timeLimit == 0 || options.timeLimit > timeLimit))
+			{
+				options.timeLimit = timeLimit;
+			}
+
+			PortfolioResult::Run & run = portfolio.runs[i];
+			run.name = strategy.name;
+			try
+			{
+				run.result = proveConjecture(premises, conjecture, strategy.engine, options);
+			}
+			catch (const char *)
+			{
+				run.result = "ERROR";
+			}
+			chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+			run.milliseconds = elapsed.count();
+
+			if (run.result == "TAUTOLOGY" || run.result == "NOT A TAUTOLOGY")
+			{
+				lock_guard<mutex> lock(winnerMutex);
+				if (portfolio.winner.empty())
+				{
+					portfolio.winner = strategy.name;
+					portfolio.result = run.result;
+					cancellation.cancel();
+				}
+			}
+		}));
+	}
+	for (thread & t : threads)
+	{
+		t.join();
+	}
+
+	if (portfolio.winner.empty())
+	{
+		// ERROR only if no strategy could work on the formula at all
+		portfolio.result = "ERROR";
+		for (const PortfolioResult::Run & run : portfolio.runs)
+		{
+			if (run.result != "ERROR")
+			{
+				portfolio.result = "UNKNOWN";
+			}
+		}
+	}
+
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+	portfolio.milliseconds = elapsed.count();
+	return portfolio;
+}
@@ -0,0 +1,61 @@
+#ifndef _PORTFOLIO_H
+#define _PORTFOLIO_H
+
+#include <string>
+#include <vector>
+
+#include "fol.hpp"
+#include "prover.h"
+#include "theory.h"
+
+/* One configuration of a portfolio: an engine with its options. */
+struct PortfolioStrategy
+{
+	// The name under which the strategy is reported
+	string name;
+	Engine engine = E_TABLEAUX;
+	TableauxOptions options;
+	// The milliseconds the strategy may run, 0 means as long as the whole portfolio
+	unsigned timeSlice = 0;
+};
+
+/* What each strategy of a portfolio gave, and which of them decided. */
+struct PortfolioResult
+{
+	struct Run
+	{
+		string name;
+		string result;
+		double milliseconds = 0;
+	};
+
+	// TAUTOLOGY or NOT A TAUTOLOGY as the winner found it, or UNKNOWN if no strategy decided
+	string result;
+	// The name of the strategy which decided, empty if none did
+	string winner;
+	double milliseconds = 0;
+	// Every strategy in the order of the portfolio; those stopped by the winner are UNKNOWN
+	vector<Run> runs;
+};
+
+/* Gives the strategies raced when no other portfolio is given: the tableaux
+with its default and with its lookahead heuristics, Inst-Gen, resolution and
+resolution from the relevant premises only. */
+vector<PortfolioStrategy> getDefaultPortfolio();
+
+/* Reads a portfolio written as strategies separated by commas, each an
+engine name followed by the options "+simplify", "+lookahead", "+models"
+and "+relevance" and optionally by ":ms", its time slice, as in
+	tableaux+lookahead:2000,instgen,resolution+relevance
+Returns false if a strategy is not correct. */
+bool parsePortfolio(const string & text, vector<PortfolioStrategy> & strategies);
+
+/* Proves the conjecture from the premises with every strategy at once, each
+on its own thread. The first strategy to give TAUTOLOGY or NOT A TAUTOLOGY
+decides, and all the others are stopped. Inst-Gen and resolution do not
+interpret equality, so for a formula with equalities they give UNKNOWN instead
+of NOT A TAUTOLOGY, and the race goes on without them. The time limit caps
+the time slices, 0 means no limit. The tableaux are not traced. */
+PortfolioResult provePortfolio(const Theory & premises, const Formula & conjecture, const vector<PortfolioStrategy> & strategies, unsigned timeLimit = 0);
+
+#endif // _PORTFOLIO_H
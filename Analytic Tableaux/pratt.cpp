@@ -0,0 +1,422 @@
+#include "stdafx.h"
+#include "pratt.h"
+
+#include <cstring>
+
+static bool isNameCharacter(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// ----------------------------------------------------------------------------
+// PrattParser
+
+PrattParser::PrattParser(const char * buffer, size_t length)
+	:_buffer(buffer), _length(length), _position(0)
+{
+	nextToken();
+}
+
+size_t PrattParser::getPosition() const
+{
+	return _position;
+}
+
+void PrattParser::nextToken()
+{
+	while (_position < _length && (_buffer[_position] == ' ' || _buffer[_position] == '\t' || _buffer[_position] == '\r' || _buffer[_position] == '\n'))
+	{
+		_position++;
+	}
+
+	_token.text = _buffer + _position;
+	_token.length = 1;
+	if (_position == _length)
+	{
+		_token.type = TK_END;
+		_token.length = 0;
+		return;
+	}
+
+	char c = _buffer[_position];
+	if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+	{
+		size_t start = _position;
+		while (_position < _length && isNameCharacter(_buffer[_position]))
+		{
+			_position++;
+		}
+		_token.length = _position - start;
+
+		if (_token.length == 4 && strncmp(_token.text, "true", 4) == 0)
+		{
+			_token.type = TK_TRUE;
+		}
+		else if (_token.length == 5 && strncmp(_token.text, "false", 5) == 0)
+		{
+			_token.type = TK_FALSE;
+		}
+		else
+		{
+			_token.type = c >= 'a' && c <= 'z' ? TK_SYMBOL : TK_VARIABLE;
+		}
+		return;
+	}
+
+	// The longest operator is taken, as the scanner does
+	size_t left = _length - _position;
+	if (left >= 3 && strncmp(_token.text, "<=>", 3) == 0)
+	{
+		_token.type = TK_IFF;
+		_token.length = 3;
+	}
+	else if (left >= 2 && strncmp(_token.text, "=>", 2) == 0)
+	{
+		_token.type = TK_IMP;
+		_token.length = 2;
+	}
+	else if (left >= 2 && strncmp(_token.text, "~=", 2) == 0)
+	{
+		_token.type = TK_NEQ;
+		_token.length = 2;
+	}
+	else
+	{
+		switch (c)
+		{
+			case '&':
+				_token.type = TK_AND;
+				break;
+			case '|':
+				_token.type = TK_OR;
+				break;
+			case '~':
+				_token.type = TK_NOT;
+				break;
+			case '=':
+				_token.type = TK_EQ;
+				break;
+			case '!':
+				_token.type = TK_FORALL;
+				break;
+			case '?':
+				_token.type = TK_EXISTS;
+				break;
+			default:
+				_token.type = TK_CHARACTER;
+				break;
+		}
+	}
+	_position += _token.length;
+}
+
+void PrattParser::fail(const string & expected)
+{
+	if (!_error.empty())
+	{
+		return;
+	}
+
+	size_t offset = _token.text - _buffer;
+	unsigned line = 1;
+	unsigned column = 1;
+	for (size_t i = 0; i < offset; i++)
+	{
+		if (_buffer[i] == '\n')
+		{
+			line++;
+			column = 1;
+		}
+		else
+		{
+			column++;
+		}
+	}
+
+	_error = "syntax error at " + to_string(line) + ":" + to_string(column) + ", expected " + expected;
+}
+
+bool PrattParser::expect(char c)
+{
+	if (_token.type != TK_CHARACTER || *_token.text != c)
+	{
+		fail(string("'") + c + "'");
+		return false;
+	}
+	nextToken();
+	return true;
+}
+
+bool PrattParser::parseNext(Formula & f, string & error)
+{
+	_error.clear();
+	error.clear();
+	f = Formula();
+
+	if (_token.type == TK_END)
+	{
+		return false;
+	}
+
+	// The last formula of the buffer may come without its ';'
+	f = parseBinary(1);
+	if (f.get() != 0 && (_token.type == TK_END || expect(';')))
+	{
+		return true;
+	}
+
+	// The rest of the formula is skipped
+	while (_token.type != TK_END && !(_token.type == TK_CHARACTER && *_token.text == ';'))
+	{
+		nextToken();
+	}
+	if (_token.type != TK_END)
+	{
+		nextToken();
+	}
+
+	f = Formula();
+	error = _error;
+	return false;
+}
+
+int PrattParser::getPrecedence(TokenType type)
+{
+	switch (type)
+	{
+		case TK_IFF:
+			return 1;
+		case TK_IMP:
+			return 2;
+		case TK_OR:
+			return 3;
+		case TK_AND:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+Formula PrattParser::parseBinary(int minPrecedence)
+{
+	Formula left = parseUnary();
+	if (left.get() == 0)
+	{
+		return left;
+	}
+
+	while (true)
+	{
+		int precedence = getPrecedence(_token.type);
+		if (precedence == 0 || precedence < minPrecedence)
+		{
+			return left;
+		}
+
+		TokenType op = _token.type;
+		nextToken();
+
+		// Only stronger connectives are taken on the right, so that equal ones group to the left
+		Formula right = parseBinary(precedence + 1);
+		if (right.get() == 0)
+		{
+			return right;
+		}
+
+		switch (op)
+		{
+			case TK_IFF:
+				left = make_shared<Iff>(left, right);
+				break;
+			case TK_IMP:
+				left = make_shared<Imp>(left, right);
+				break;
+			case TK_OR:
+				left = make_shared<Or>(left, right);
+				break;
+			default:
+				left = make_shared<And>(left, right);
+				break;
+		}
+	}
+}
+
+Formula PrattParser::parseUnary()
+{
+	switch (_token.type)
+	{
+		case TK_NOT:
+		{
+			nextToken();
+			Formula op = parseUnary();
+			return op.get() == 0 ? op : make_shared<Not>(op);
+		}
+		case TK_FORALL:
+		case TK_EXISTS:
+		{
+			bool forall = _token.type == TK_FORALL;
+			nextToken();
+			if (!expect('['))
+			{
+				return Formula();
+			}
+			if (_token.type != TK_VARIABLE)
+			{
+				fail("a variable");
+				return Formula();
+			}
+			Variable v(_token.text, _token.length);
+			nextToken();
+			if (!expect(']') || !expect(':'))
+			{
+				return Formula();
+			}
+
+			Formula op = parseUnary();
+			if (op.get() == 0)
+			{
+				return op;
+			}
+			if (forall)
+			{
+				return make_shared<Forall>(v, op);
+			}
+			return make_shared<Exists>(v, op);
+		}
+		case TK_CHARACTER:
+		{
+			if (*_token.text != '(')
+			{
+				break;
+			}
+			nextToken();
+			Formula f = parseBinary(1);
+			if (f.get() == 0 || !expect(')'))
+			{
+				return Formula();
+			}
+			return f;
+		}
+		default:
+			break;
+	}
+	return parseAtomic();
+}
+
+Formula PrattParser::parseAtomic()
+{
+	switch (_token.type)
+	{
+		case TK_TRUE:
+			nextToken();
+			return make_shared<True>();
+		case TK_FALSE:
+			nextToken();
+			return make_shared<False>();
+		case TK_SYMBOL:
+		case TK_VARIABLE:
+			break;
+		default:
+			fail("a formula");
+			return Formula();
+	}
+
+	// Both an atom and the left side of an equality begin with a term
+	bool isVariable = _token.type == TK_VARIABLE;
+	string symbol(_token.text, _token.length);
+	vector<Term> operands;
+	nextToken();
+
+	if (!isVariable && _token.type == TK_CHARACTER && *_token.text == '(')
+	{
+		nextToken();
+		if (!parseTerms(operands) || !expect(')'))
+		{
+			return Formula();
+		}
+	}
+
+	if (_token.type == TK_EQ || _token.type == TK_NEQ)
+	{
+		bool equality = _token.type == TK_EQ;
+		Term left;
+		if (isVariable)
+		{
+			left = make_shared<VariableTerm>(symbol);
+		}
+		else
+		{
+			left = make_shared<FunctionTerm>(symbol, move(operands));
+		}
+
+		nextToken();
+		Term right = parseTerm();
+		if (right.get() == 0)
+		{
+			return Formula();
+		}
+		if (equality)
+		{
+			return make_shared<Equality>(left, right);
+		}
+		return make_shared<Disequality>(left, right);
+	}
+
+	if (isVariable)
+	{
+		fail("'=' or '~='");
+		return Formula();
+	}
+	return make_shared<Atom>(symbol, move(operands));
+}
+
+Term PrattParser::parseTerm()
+{
+	if (_token.type == TK_VARIABLE)
+	{
+		Term t = make_shared<VariableTerm>(Variable(_token.text, _token.length));
+		nextToken();
+		return t;
+	}
+	if (_token.type != TK_SYMBOL)
+	{
+		fail("a term");
+		return Term();
+	}
+
+	FunctionSymbol symbol(_token.text, _token.length);
+	vector<Term> operands;
+	nextToken();
+
+	if (_token.type == TK_CHARACTER && *_token.text == '(')
+	{
+		nextToken();
+		if (!parseTerms(operands) || !expect(')'))
+		{
+			return Term();
+		}
+	}
+	return make_shared<FunctionTerm>(symbol, move(operands));
+}
+
+bool PrattParser::parseTerms(vector<Term> & terms)
+{
+	while (true)
+	{
+		Term t = parseTerm();
+		if (t.get() == 0)
+		{
+			return false;
+		}
+		terms.push_back(t);
+
+		if (_token.type != TK_CHARACTER || *_token.text != ',')
+		{
+			return true;
+		}
+		nextToken();
+	}
+}
+
+// END PrattParser
+// ----------------------------------------------------------------------------
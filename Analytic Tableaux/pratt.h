@@ -0,0 +1,60 @@
+#ifndef _PRATT_H
+#define _PRATT_H
+
+#include <string>
+
+#include "fol.hpp"
+
+/* A hand-written parser for the same syntax as parser.ypp. It reads the
+formulas one after another straight from a memory buffer, without copying
+the buffer; a token is only a position in it. The binary connectives are
+parsed by precedence climbing: <=> binds weakest, then =>, | and &, and
+all of them group to the left, as in the grammar. --selftest checks that
+both give the same formulas. */
+class PrattParser
+{
+private:
+	enum TokenType
+	{
+		TK_END, TK_SYMBOL, TK_VARIABLE, TK_TRUE, TK_FALSE,
+		TK_NOT, TK_AND, TK_OR, TK_IMP, TK_IFF, TK_EQ, TK_NEQ,
+		TK_FORALL, TK_EXISTS, TK_CHARACTER
+	};
+
+	struct Token
+	{
+		TokenType type;
+		const char * text;
+		size_t length;
+	};
+
+	const char * _buffer;
+	size_t _length;
+	size_t _position;
+	Token _token;
+	string _error;
+
+	void nextToken();
+	bool expect(char c);
+	void fail(const string & expected);
+
+	static int getPrecedence(TokenType type);
+	Formula parseBinary(int minPrecedence);
+	Formula parseUnary();
+	Formula parseAtomic();
+	Term parseTerm();
+	bool parseTerms(vector<Term> & terms);
+public:
+	PrattParser(const char * buffer, size_t length);
+
+	/* Parses the next formula with its ';', which may be left out after the
+	last formula of the buffer. Returns false at the end of the
+	buffer, or if the formula is not correct; then the error is set and the
+	rest of that formula is skipped, so that the next one can be parsed. */
+	bool parseNext(Formula & f, string & error);
+
+	// How far the buffer has been read
+	size_t getPosition() const;
+};
+
+#endif // _PRATT_H
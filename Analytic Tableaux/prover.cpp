@@ -0,0 +1,184 @@
+#include "stdafx.h"
+#include "prover.h"
+#include "instgen.h"
+#include "resolution.h"
+#include "pratt.h"
+#include "mappedfile.h"
+#include "tptp.h"
+#include "strategy.h"
+
+bool parseEngine(const string & name, Engine & engine)
+{
+	if (name == "tableaux")
+	{
+		engine = E_TABLEAUX;
+	}
+	else if (name == "instgen")
+	{
+		engine = E_INSTGEN;
+	}
+	else if (name == "resolution")
+	{
+		engine = E_RESOLUTION;
+	}
+	else if (name == "auto")
+	{
+		engine = E_AUTO;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+Formula parseFormula(const string & text, string & error)
+{
+	PrattParser parser(text.c_str(), text.size());
+	Formula f;
+	if (!parser.parseNext(f, error) && error.empty())
+	{
+		error = "no formula";
+	}
+	return f;
+}
+
+string proveFormula(const Formula & f, Engine engine, const TableauxOptions & options, EngineReport * report)
+{
+	return proveConjecture(Theory(), f, engine, options, report);
+}
+
+// The limit of Inst-Gen or resolution; no limit makes them UNKNOWN for a formula with equalities they did not prove
+static string getEngineLimit(bool outOfTime, const TableauxOptions & options)
+{
+	if (!outOfTime)
+	{
+		return "";
+	}
+	return getLimitName(options.cancellation.isCancelled() ? TL_CANCELLED : TL_TIME);
+}
+
+static string proveWith(const Theory & premises, const Formula & conjecture, Engine engine, const TableauxOptions & options, EngineReport * report)
+{
+	switch (engine)
+	{
+	case E_INSTGEN:
+	{
+		InstGen ig(premises, conjecture, options.timeLimit, options.cancellation);
+		if (report != nullptr)
+		{
+			report->limit = getEngineLimit(ig.isOutOfTime(), options);
+			report->steps = ig.getRoundCount();
+			report->clauses = ig.getClauseCount();
+		}
+		return ig.getResult();
+	}
+	case E_RESOLUTION:
+	{
+		Resolution r(premises, conjecture, options.timeLimit, options.cancellation);
+		if (report != nullptr)
+		{
+			report->limit = getEngineLimit(r.isOutOfTime(), options);
+			report->steps = r.getSelectionCount();
+			report->clauses = r.getClauseCount();
+		}
+		return r.getResult();
+	}
+	default:
+	{
+		Tableaux t(premises, conjecture, options);
+		if (report != nullptr)
+		{
+			TableauxStatistics statistics = t.getStatistics();
+			report->limit = getLimitName(t.getLimit());
+			report->steps = statistics.ruleApplications;
+			report->closedBranches = statistics.closedBranches;
+			report->openBranches = statistics.openBranches;
+			report->peakMemory = statistics.peakMemory;
+			report->counterModel = t.getCounterModel();
+		}
+		return t.getResult();
+	}
+	}
+}
+
+string proveConjecture(const Theory & premises, const Formula & conjecture, Engine engine, const TableauxOptions & options, EngineReport * report)
+{
+	if (report != nullptr)
+	{
+		*report = EngineReport();
+	}
+
+	if (engine == E_AUTO)
+	{
+		PortfolioStrategy strategy = selectStrategy(premises, conjecture, options);
+		string result = proveConjecture(premises, conjecture, strategy.engine, strategy.options, report);
+		if (report != nullptr)
+		{
+			report->strategy = strategy.name;
+		}
+		return result;
+	}
+
+	unique_ptr<Theory> relevant;
+	if (options.relevanceDepth > 0 && conjecture.get() != 0)
+	{
+		relevant = premises.selectRelevant(conjecture, options.relevanceDepth, options.relevanceTolerance);
+	}
+	if (relevant == nullptr)
+	{
+		return proveWith(premises, conjecture, engine, options, report);
+	}
+
+	// A counterexample from some of the premises need not be one from all of them
+	string result = proveWith(*relevant, conjecture, engine, options, report);
+	if (result != "NOT A TAUTOLOGY")
+	{
+		return result;
+	}
+	if (report != nullptr)
+	{
+		report->counterModel.clear();
+	}
+	return "UNKNOWN";
+}
+
+static bool hasExtension(const string & path, const string & extension)
+{
+	return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+bool readPremises(const string & path, const string & includeDirectory, vector<Formula> & premises, string & error)
+{
+	if (hasExtension(path, ".p") || hasExtension(path, ".ax"))
+	{
+		TptpProblem problem;
+		if (!readTptpFile(path, includeDirectory, problem, error))
+		{
+			return false;
+		}
+		premises = problem.premises;
+		return true;
+	}
+
+	MappedFile file;
+	if (!file.open(path))
+	{
+		error = "cannot open " + path;
+		return false;
+	}
+
+	PrattParser parser(file.getData(), file.getSize());
+	Formula f;
+	premises.clear();
+	while (parser.parseNext(f, error))
+	{
+		premises.push_back(f);
+	}
+	if (!error.empty())
+	{
+		error = path + ": " + error;
+		return false;
+	}
+	return true;
+}
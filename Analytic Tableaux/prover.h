@@ -0,0 +1,65 @@
+#ifndef _PROVER_H
+#define _PROVER_H
+
+#include <string>
+
+#include "fol.hpp"
+#include "tableaux.h"
+#include "theory.h"
+
+/* The proving engines which can be selected from the command line. */
+enum Engine
+{
+	E_TABLEAUX,
+	E_INSTGEN,
+	E_RESOLUTION,
+	// The engine and the heuristics are chosen for each formula by selectStrategy
+	E_AUTO
+};
+
+/* What the engine told about a proof besides its result. */
+struct EngineReport
+{
+	// Which limit made the result UNKNOWN, as getLimitName gives it, or empty if none did
+	string limit;
+	// Rule applications of the tableaux, rounds of Inst-Gen or given clauses of resolution
+	unsigned steps = 0;
+	unsigned closedBranches = 0;
+	unsigned openBranches = 0;
+	// The clauses kept by Inst-Gen or resolution
+	unsigned clauses = 0;
+	// The most memory of the process seen by the tableaux, if it had a memory limit
+	size_t peakMemory = 0;
+	// For NOT A TAUTOLOGY from the tableaux, the counter-model as Tableaux::getCounterModel gives it
+	string counterModel;
+	// The strategy chosen for the engine E_AUTO
+	string strategy;
+};
+
+/* Reads the engine name given on the command line. Returns false if
+the name is not known. */
+bool parseEngine(const string & name, Engine & engine);
+
+/* Parses a formula, with or without its terminating ';'. Returns an
+empty formula and sets the error if the text is not a correct formula. */
+Formula parseFormula(const string & text, string & error);
+
+/* Proves the formula with the given engine and returns the result
+in the same form as the engines do. If a report is asked for, it is filled
+in from the engine. */
+string proveFormula(const Formula & f, Engine engine, const TableauxOptions & options, EngineReport * report = nullptr);
+
+/* Proves that the conjecture follows from the premises, in the same form
+as proveFormula. With options.relevanceDepth set, it is proved only from the
+premises relevant to it, and then the result is UNKNOWN instead of NOT A
+TAUTOLOGY if some premises were left out. This is where the results of all
+the engines are interpreted, for the program and for the library alike. */
+string proveConjecture(const Theory & premises, const Formula & conjecture, Engine engine, const TableauxOptions & options, EngineReport * report = nullptr);
+
+/* Reads the premises from a file with one formula after another, or the
+premises of a TPTP file (*.p or *.ax), whose includes are also looked up in
+the include directory. Returns false and sets the error if the file cannot
+be read or a formula in it is not correct. */
+bool readPremises(const string & path, const string & includeDirectory, vector<Formula> & premises, string & error);
+
+#endif // _PROVER_H
@@ -0,0 +1,190 @@
+#include "stdafx.h"
+#include "relevance.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+// The kinds of the symbols are kept apart, as a predicate may have the name of a constant
+static void getTermSymbols(const Term & t, vector<string> & names)
+{
+	if (t->getType() != BaseTerm::TT_FUNCTION)
+	{
+		return;
+	}
+
+	FunctionTerm * pFunction = (FunctionTerm *)t.get();
+	names.push_back("f " + pFunction->getSymbol());
+	for (const Term & operand : pFunction->getOperands())
+	{
+		getTermSymbols(operand, names);
+	}
+}
+
+static void getSymbols(const Formula & f, vector<string> & names)
+{
+	switch (f->getType())
+	{
+		case BaseFormula::T_ATOM:
+		{
+			Atom * pAtom = (Atom *)f.get();
+			if (pAtom->getSymbol() != "=" && pAtom->getSymbol() != "~=")
+			{
+				names.push_back("p " + pAtom->getSymbol());
+			}
+			for (const Term & operand : pAtom->getOperands())
+			{
+				getTermSymbols(operand, names);
+			}
+			break;
+		}
+		case BaseFormula::T_NOT:
+			getSymbols(((Not *)f.get())->getOperand(), names);
+			break;
+		case BaseFormula::T_AND:
+		case BaseFormula::T_OR:
+		case BaseFormula::T_IMP:
+		case BaseFormula::T_IFF:
+		{
+			BinaryConjective * pBinary = (BinaryConjective *)f.get();
+			getSymbols(pBinary->getOperand1(), names);
+			getSymbols(pBinary->getOperand2(), names);
+			break;
+		}
+		case BaseFormula::T_FORALL:
+		case BaseFormula::T_EXISTS:
+			getSymbols(((Quantifier *)f.get())->getOperand(), names);
+			break;
+		default:
+			break;
+	}
+}
+
+// ----------------------------------------------------------------------------
+// RelevanceFilter
+
+RelevanceFilter::RelevanceFilter(const vector<Formula> & premises)
+	:_premises(premises), _symbols(premises.size())
+{
+	for (unsigned i = 0; i < _premises.size(); i++)
+	{
+		vector<string> names;
+		getSymbols(_premises[i], names);
+		addSymbols(names, _symbols[i]);
+		for (unsigned symbol : _symbols[i])
+		{
+			_occurrences[symbol]++;
+		}
+	}
+
+	for (unsigned i = 0; i < _premises.size(); i++)
+	{
+		unsigned rarest = (unsigned)_premises.size();
+		for (unsigned symbol : _symbols[i])
+		{
+			rarest = min(rarest, _occurrences[symbol]);
+		}
+		for (unsigned symbol : _symbols[i])
+		{
+			_triggers[symbol].push_back(Trigger{ i, rarest });
+		}
+	}
+
+	// A symbol triggers a premise if its rarest symbol is common enough, so
+	// the premises it triggers are at the front of its list
+	for (vector<Trigger> & triggers : _triggers)
+	{
+		stable_sort(triggers.begin(), triggers.end(), [](const Trigger & t1, const Trigger & t2)
+		{
+			return t1.rarest > t2.rarest;
+		});
+	}
+}
+
+void RelevanceFilter::addSymbols(const vector<string> & names, vector<unsigned> & symbols)
+{
+	for (const string & name : names)
+	{
+		unordered_map<string, unsigned>::const_iterator iter = _symbolIndexes.find(name);
+		unsigned symbol;
+		if (iter != _symbolIndexes.end())
+		{
+			symbol = iter->second;
+		}
+		else
+		{
+			symbol = (unsigned)_occurrences.size();
+			_symbolIndexes[name] = symbol;
+			_occurrences.push_back(0);
+			_triggers.push_back(vector<Trigger>());
+		}
+
+		// Every symbol is counted once for each premise
+		if (find(symbols.begin(), symbols.end(), symbol) == symbols.end())
+		{
+			symbols.push_back(symbol);
+		}
+	}
+}
+
+vector<Formula> RelevanceFilter::select(const Formula & conjecture, unsigned depth, double tolerance) const
+{
+	vector<bool> selected(_premises.size(), false);
+	vector<bool> reached(_occurrences.size(), false);
+
+	// The symbols of the conjecture which occur in no premise trigger nothing
+	vector<string> names;
+	getSymbols(conjecture, names);
+	vector<unsigned> symbols;
+	for (const string & name : names)
+	{
+		unordered_map<string, unsigned>::const_iterator iter = _symbolIndexes.find(name);
+		if (iter != _symbolIndexes.end() && !reached[iter->second])
+		{
+			reached[iter->second] = true;
+			symbols.push_back(iter->second);
+		}
+	}
+
+	for (unsigned step = 0; step < depth && !symbols.empty(); step++)
+	{
+		vector<unsigned> nextSymbols;
+		for (unsigned symbol : symbols)
+		{
+			for (const Trigger & trigger : _triggers[symbol])
+			{
+				if (_occurrences[symbol] > tolerance * trigger.rarest)
+				{
+					break;
+				}
+				if (selected[trigger.premise])
+				{
+					continue;
+				}
+
+				selected[trigger.premise] = true;
+				for (unsigned next : _symbols[trigger.premise])
+				{
+					if (!reached[next])
+					{
+						reached[next] = true;
+						nextSymbols.push_back(next);
+					}
+				}
+			}
+		}
+		symbols.swap(nextSymbols);
+	}
+
+	vector<Formula> premises;
+	for (unsigned i = 0; i < _premises.size(); i++)
+	{
+		if (selected[i])
+		{
+			premises.push_back(_premises[i]);
+		}
+	}
+	return premises;
+}
+
+// END RelevanceFilter
+// ----------------------------------------------------------------------------
@@ -0,0 +1,51 @@
+#ifndef _RELEVANCE_H
+#define _RELEVANCE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fol.hpp"
+
+/* Selects the premises relevant to a conjecture in the way of SInE (the
+Sumo Inference Engine). The symbols of a formula are its predicate symbols,
+its function symbols and its constants, without the equality. A symbol
+triggers a premise in which it occurs if it occurs in at most tolerance
+times as many premises as the rarest symbol of that premise, so a premise is
+triggered by its rare symbols and not by the common ones. The symbols of the
+conjecture trigger the premises of the first step, their symbols those of
+the second step, and so on.
+
+The index of the symbols is built once, and a selection takes time in
+proportion to the premises it looks at, so the filter can be shared by many
+conjectures, also on several threads. */
+class RelevanceFilter
+{
+private:
+	struct Trigger
+	{
+		unsigned premise;
+		// The number of the premises in which the rarest symbol of the premise occurs
+		unsigned rarest;
+	};
+
+	vector<Formula> _premises;
+	unordered_map<string, unsigned> _symbolIndexes;
+	// The number of the premises in which each symbol occurs
+	vector<unsigned> _occurrences;
+	// For each symbol, the premises in which it occurs, those with the most common rarest symbol first
+	vector<vector<Trigger>> _triggers;
+	// For each premise, its symbols
+	vector<vector<unsigned>> _symbols;
+
+	void addSymbols(const vector<string> & names, vector<unsigned> & symbols);
+public:
+	RelevanceFilter(const vector<Formula> & premises);
+
+	/* Gives the premises selected in at most depth steps from the symbols of
+	the conjecture, in the order of the premises. The tolerance is at least 1;
+	the greater it is, the more premises are selected. */
+	vector<Formula> select(const Formula & conjecture, unsigned depth, double tolerance) const;
+};
+
+#endif // _RELEVANCE_H
@@ -0,0 +1,402 @@
+#include "stdafx.h"
+#include "resolution.h"
+#include "theory.h"
+
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+// FeatureVectorIndex
+
+void FeatureVectorIndex::insert(unsigned id, const vector<unsigned> & features)
+{
+	Node * node = &_root;
+	for (unsigned feature : features)
+	{
+		unique_ptr<Node> & child = node->children[feature];
+		if (!child)
+		{
+			child.reset(new Node());
+		}
+		node = child.get();
+	}
+	node->ids.push_back(id);
+}
+
+void FeatureVectorIndex::remove(unsigned id, const vector<unsigned> & features)
+{
+	Node * node = &_root;
+	for (unsigned feature : features)
+	{
+		map<unsigned, unique_ptr<Node>>::iterator iter = node->children.find(feature);
+		if (iter == node->children.end())
+		{
+			return;
+		}
+		node = iter->second.get();
+	}
+
+	vector<unsigned>::iterator iter = find(node->ids.begin(), node->ids.end(), id);
+	if (iter != node->ids.end())
+	{
+		node->ids.erase(iter);
+	}
+}
+
+void FeatureVectorIndex::collect(const Node & node, const vector<unsigned> & features, unsigned depth, bool generalizations, vector<unsigned> & ids) const
+{
+	if (depth == features.size())
+	{
+		ids.insert(ids.end(), node.ids.begin(), node.ids.end());
+		return;
+	}
+
+	map<unsigned, unique_ptr<Node>>::const_iterator begin, end;
+	if (generalizations)
+	{
+		begin = node.children.cbegin();
+		end = node.children.upper_bound(features[depth]);
+	}
+	else
+	{
+		begin = node.children.lower_bound(features[depth]);
+		end = node.children.cend();
+	}
+
+	for (; begin != end; ++begin)
+	{
+		collect(*begin->second, features, depth + 1, generalizations, ids);
+	}
+}
+
+void FeatureVectorIndex::findGeneralizations(const vector<unsigned> & features, vector<unsigned> & ids) const
+{
+	collect(_root, features, 0, true, ids);
+}
+
+void FeatureVectorIndex::findInstances(const vector<unsigned> & features, vector<unsigned> & ids) const
+{
+	collect(_root, features, 0, false, ids);
+}
+
+// END FeatureVectorIndex
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Resolution
+
+Resolution::Resolution(const Formula & root, unsigned timeLimit)
+	:Resolution(Theory(), root, timeLimit)
+{}
+
+Resolution::Resolution(const Theory & premises, const Formula & conjecture, unsigned timeLimit, const CancellationToken & cancellation)
+	:_selections(0), _timeLimit(timeLimit), _cancellation(cancellation), _outOfTime(false)
+{
+	_deadline = chrono::steady_clock::now() + chrono::milliseconds(timeLimit);
+
+	// The conjecture follows if and only if the clauses of the premises and of its negation are unsatisfiable
+	vector<Clause> clauses = premises.getClauses();
+	if (conjecture.get() != 0)
+	{
+		Clausifier clausifier = premises.getClausifier();
+		vector<Clause> negated = clausifier.clausifyNegation(conjecture);
+		clauses.insert(clauses.end(), negated.begin(), negated.end());
+	}
+	_hasEquality = containsEquality(clauses);
+
+	// Inferences never introduce new predicate symbols, so the features can be fixed up front
+	for (unsigned i = 0; i < clauses.size(); ++i)
+	{
+		for (unsigned j = 0; j < clauses[i].size(); ++j)
+		{
+			LiteralKey key(((Atom *)clauses[i][j].atom.get())->getSymbol(), clauses[i][j].sign);
+			if (_featureSlots.find(key) == _featureSlots.end())
+			{
+				unsigned slot = _featureSlots.size() + 2;
+				_featureSlots[key] = slot;
+			}
+		}
+	}
+
+	_result = false;
+	for (unsigned i = 0; i < clauses.size(); ++i)
+	{
+		if (addPassiveClause(clauses[i]))
+		{
+			_result = true;
+			return;
+		}
+	}
+
+	_result = prove();
+}
+
+string Resolution::getResult() const
+{
+	// Without the axioms of equality, saturation says nothing about the models where = is equality
+	if (_outOfTime || (!_result && _hasEquality))
+	{
+		return "UNKNOWN";
+	}
+	return _result ? "TAUTOLOGY" : "NOT A TAUTOLOGY";
+}
+
+bool Resolution::isOutOfTime() const
+{
+	return _outOfTime;
+}
+
+unsigned Resolution::getSelectionCount() const
+{
+	return _selections;
+}
+
+unsigned Resolution::getClauseCount() const
+{
+	return _clauses.size();
+}
+
+bool Resolution::prove()
+{
+	unsigned given;
+	while (selectGivenClause(given))
+	{
+		if ((_timeLimit != 0 && chrono::steady_clock::now() >= _deadline) || _cancellation.isCancelled())
+		{
+			_outOfTime = true;
+			return false;
+		}
+
+		// The clause may have been subsumed by a clause activated after it was generated
+		if (isForwardSubsumed(_clauses[given], _features[given]))
+		{
+			_deleted[given] = true;
+			continue;
+		}
+
+		removeBackwardSubsumed(given);
+		activate(given);
+
+		vector<Clause> inferred;
+		generateResolvents(given, inferred);
+		generateFactors(given, inferred);
+
+		for (unsigned i = 0; i < inferred.size(); ++i)
+		{
+			if (addPassiveClause(inferred[i]))
+			{
+				return true;
+			}
+		}
+	}
+
+	// The clause set is saturated without the empty clause
+	return false;
+}
+
+bool Resolution::selectGivenClause(unsigned & given)
+{
+	while (!_passiveByWeight.empty() || !_passiveByAge.empty())
+	{
+		// Mostly the lightest clause, but every fifth time the oldest one, for fairness
+		if ((++_selections % 5 == 0 && !_passiveByAge.empty()) || _passiveByWeight.empty())
+		{
+			given = _passiveByAge.front();
+			_passiveByAge.pop_front();
+		}
+		else
+		{
+			given = _passiveByWeight.top().second;
+			_passiveByWeight.pop();
+		}
+
+		// The other queue still holds the clause, so it may come up again
+		if (_deleted[given] || _active[given])
+		{
+			continue;
+		}
+
+		_passiveIndex.remove(given, _features[given]);
+		return true;
+	}
+
+	return false;
+}
+
+bool Resolution::addPassiveClause(Clause c)
+{
+	if (!normalizeClause(c))
+	{
+		// Tautologies are useless
+		return false;
+	}
+
+	if (c.empty())
+	{
+		return true;
+	}
+
+	c = renameClauseVariables(c, "X");
+	vector<unsigned> features = getFeatures(c);
+	if (isForwardSubsumed(c, features))
+	{
+		return false;
+	}
+
+	unsigned id = _clauses.size();
+	_clauses.push_back(c);
+	_features.push_back(features);
+	_deleted.push_back(false);
+	_active.push_back(false);
+
+	_passiveIndex.insert(id, features);
+	_passiveByWeight.push(make_pair(getClauseWeight(c), id));
+	_passiveByAge.push_back(id);
+	return false;
+}
+
+void Resolution::activate(unsigned given)
+{
+	_active[given] = true;
+	_activeIndex.insert(given, _features[given]);
+
+	const Clause & c = _clauses[given];
+	for (unsigned i = 0; i < c.size(); ++i)
+	{
+		vector<unsigned> & ids = _activeLiterals[LiteralKey(((Atom *)c[i].atom.get())->getSymbol(), c[i].sign)];
+		if (ids.empty() || ids.back() != given)
+		{
+			ids.push_back(given);
+		}
+	}
+}
+
+bool Resolution::isForwardSubsumed(const Clause & c, const vector<unsigned> & features) const
+{
+	vector<unsigned> candidates;
+	_activeIndex.findGeneralizations(features, candidates);
+	_passiveIndex.findGeneralizations(features, candidates);
+
+	for (unsigned id : candidates)
+	{
+		if (!_deleted[id] && subsumes(_clauses[id], c))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Resolution::removeBackwardSubsumed(unsigned given)
+{
+	vector<unsigned> candidates;
+	_activeIndex.findInstances(_features[given], candidates);
+	_passiveIndex.findInstances(_features[given], candidates);
+
+	for (unsigned id : candidates)
+	{
+		if (id != given && !_deleted[id] && subsumes(_clauses[given], _clauses[id]))
+		{
+			_deleted[id] = true;
+			if (_active[id])
+			{
+				_activeIndex.remove(id, _features[id]);
+			}
+			else
+			{
+				_passiveIndex.remove(id, _features[id]);
+			}
+		}
+	}
+}
+
+void Resolution::generateResolvents(unsigned given, vector<Clause> & inferred) const
+{
+	const Clause & g = _clauses[given];
+
+	for (unsigned i = 0; i < g.size(); ++i)
+	{
+		// Partners are the active clauses with a literal of the same predicate and the opposite sign
+		map<LiteralKey, vector<unsigned> >::const_iterator iter = _activeLiterals.find(LiteralKey(((Atom *)g[i].atom.get())->getSymbol(), !g[i].sign));
+		if (iter == _activeLiterals.cend())
+		{
+			continue;
+		}
+
+		for (unsigned id : iter->second)
+		{
+			if (_deleted[id])
+			{
+				continue;
+			}
+
+			// Rename the variables of the partner apart
+			Clause p = renameClauseVariables(_clauses[id], "Y");
+			for (unsigned j = 0; j < p.size(); ++j)
+			{
+				Substitution mgu;
+				if (p[j].sign == g[i].sign || !unifyAtoms(g[i].atom, p[j].atom, mgu))
+				{
+					continue;
+				}
+
+				Clause resolvent;
+				for (unsigned k = 0; k < g.size(); ++k)
+				{
+					if (k != i)
+					{
+						resolvent.push_back(g[k]);
+					}
+				}
+				for (unsigned k = 0; k < p.size(); ++k)
+				{
+					if (k != j)
+					{
+						resolvent.push_back(p[k]);
+					}
+				}
+				inferred.push_back(applySubstitution(resolvent, mgu));
+			}
+		}
+	}
+}
+
+void Resolution::generateFactors(unsigned given, vector<Clause> & inferred) const
+{
+	const Clause & g = _clauses[given];
+
+	for (unsigned i = 0; i < g.size(); ++i)
+	{
+		for (unsigned j = i + 1; j < g.size(); ++j)
+		{
+			Substitution mgu;
+			if (g[i].sign == g[j].sign && unifyAtoms(g[i].atom, g[j].atom, mgu))
+			{
+				// The two literals become equal, and normalizeClause merges them
+				inferred.push_back(applySubstitution(g, mgu));
+			}
+		}
+	}
+}
+
+vector<unsigned> Resolution::getFeatures(const Clause & c) const
+{
+	// The numbers of positive and negative literals, and the number of literals for each predicate and sign
+	vector<unsigned> features(_featureSlots.size() + 2, 0);
+
+	for (unsigned i = 0; i < c.size(); ++i)
+	{
+		++features[c[i].sign ? 0 : 1];
+
+		map<LiteralKey, unsigned>::const_iterator iter = _featureSlots.find(LiteralKey(((Atom *)c[i].atom.get())->getSymbol(), c[i].sign));
+		if (iter != _featureSlots.cend())
+		{
+			++features[iter->second];
+		}
+	}
+
+	return features;
+}
+
+// END Resolution
+// ----------------------------------------------------------------------------
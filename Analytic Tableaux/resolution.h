@@ -0,0 +1,95 @@
+#ifndef _RESOLUTION_H
+#define _RESOLUTION_H
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "cancellation.h"
+#include "clause.h"
+
+class Theory;
+
+/* Trie over the feature vectors of clauses. A clause c can subsume a clause d
+only if every feature of c is at most the same feature of d, so the trie is
+used to prefilter the candidates of forward and backward subsumption. */
+class FeatureVectorIndex
+{
+private:
+	struct Node
+	{
+		map<unsigned, unique_ptr<Node>> children;
+		vector<unsigned> ids;
+	};
+
+	Node _root;
+
+	void collect(const Node & node, const vector<unsigned> & features, unsigned depth, bool generalizations, vector<unsigned> & ids) const;
+public:
+	void insert(unsigned id, const vector<unsigned> & features);
+	void remove(unsigned id, const vector<unsigned> & features);
+	// Clauses whose features are all at most the given ones, i.e. those that may subsume it
+	void findGeneralizations(const vector<unsigned> & features, vector<unsigned> & ids) const;
+	// Clauses whose features are all at least the given ones, i.e. those that it may subsume
+	void findInstances(const vector<unsigned> & features, vector<unsigned> & ids) const;
+};
+
+/* Saturation prover with the given-clause loop. The clauses of the negated
+formula are saturated under binary resolution and factoring, discarding
+tautologies and subsumed clauses. Deriving the empty clause means the formula
+is a tautology, and saturating without it means it is not. Equality is an
+ordinary predicate here, so if the clauses contain it, saturating without the
+empty clause gives UNKNOWN. */
+class Resolution
+{
+private:
+	typedef pair<PredicateSymbol, bool> LiteralKey;
+
+	vector<Clause> _clauses;
+	vector< vector<unsigned> > _features;
+	vector<bool> _deleted;
+	vector<bool> _active;
+	map<LiteralKey, unsigned> _featureSlots;
+	map<LiteralKey, vector<unsigned> > _activeLiterals;
+	FeatureVectorIndex _activeIndex;
+	FeatureVectorIndex _passiveIndex;
+	priority_queue< pair<unsigned, unsigned>, vector< pair<unsigned, unsigned> >, greater< pair<unsigned, unsigned> > > _passiveByWeight;
+	deque<unsigned> _passiveByAge;
+	unsigned _selections;
+	unsigned _timeLimit;
+	chrono::steady_clock::time_point _deadline;
+	CancellationToken _cancellation;
+	bool _outOfTime;
+	bool _hasEquality;
+	bool _result;
+
+	bool prove();
+	bool selectGivenClause(unsigned & given);
+	bool addPassiveClause(Clause c);
+	void activate(unsigned given);
+	bool isForwardSubsumed(const Clause & c, const vector<unsigned> & features) const;
+	void removeBackwardSubsumed(unsigned given);
+	void generateResolvents(unsigned given, vector<Clause> & inferred) const;
+	void generateFactors(unsigned given, vector<Clause> & inferred) const;
+	vector<unsigned> getFeatures(const Clause & c) const;
+public:
+	// The result is UNKNOWN if the proof takes more milliseconds than the time limit, 0 means no limit
+	Resolution(const Formula & root, unsigned timeLimit = 0);
+	// Proves that the conjecture follows from the premises, or without a conjecture that they are unsatisfiable.
+	// The result is also UNKNOWN if the token is cancelled while the proof runs
+	Resolution(const Theory & premises, const Formula & conjecture, unsigned timeLimit = 0, const CancellationToken & cancellation = CancellationToken());
+
+	// TAUTOLOGY, NOT A TAUTOLOGY, or UNKNOWN if out of time or if there are equalities and no proof
+	string getResult() const;
+	// Whether the proof gave up because it was out of time or cancelled
+	bool isOutOfTime() const;
+	// The number of given clauses selected so far
+	unsigned getSelectionCount() const;
+	unsigned getClauseCount() const;
+};
+
+#endif // _RESOLUTION_H
@@ -0,0 +1,351 @@
+#include "stdafx.h"
+#include "sat.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+// ----------------------------------------------------------------------------
+// SatSolver
+
+SatSolver::SatSolver()
+	:_propagated(0),
+	_activityIncrement(1.0),
+	_unsatisfiable(false)
+{}
+
+int SatSolver::newVariable()
+{
+	_values.push_back(-1);
+	_phases.push_back(false);
+	_levels.push_back(0);
+	_reasons.push_back(-1);
+	_activities.push_back(0.0);
+	_watches.push_back(vector<int>());
+	_watches.push_back(vector<int>());
+	return (int)_values.size();
+}
+
+unsigned SatSolver::getVariableCount() const
+{
+	return _values.size();
+}
+
+signed char SatSolver::valueOf(int lit) const
+{
+	signed char value = _values[lit >> 1];
+	if (value < 0)
+	{
+		return -1;
+	}
+	return (lit & 1) ? !value : value;
+}
+
+void SatSolver::assign(int lit, int reason)
+{
+	_values[lit >> 1] = !(lit & 1);
+	_levels[lit >> 1] = _trailLimits.size();
+	_reasons[lit >> 1] = reason;
+	_trail.push_back(lit);
+}
+
+void SatSolver::attachClause(const vector<int> & clause)
+{
+	_clauses.push_back(clause);
+	_watches[clause[0]].push_back(_clauses.size() - 1);
+	_watches[clause[1]].push_back(_clauses.size() - 1);
+}
+
+void SatSolver::addClause(const vector<SatLiteral> & clause)
+{
+	if (_unsatisfiable)
+	{
+		return;
+	}
+
+	vector<int> lits;
+	for (SatLiteral l : clause)
+	{
+		int var = abs(l) - 1;
+		while ((int)_values.size() <= var)
+		{
+			newVariable();
+		}
+
+		int lit = 2 * var + (l < 0 ? 1 : 0);
+
+		// Clauses are added at level 0, where the fixed literals can be dropped right away
+		signed char value = valueOf(lit);
+		if (value == 1 || find(lits.cbegin(), lits.cend(), lit ^ 1) != lits.cend())
+		{
+			return;
+		}
+		if (value == 0 || find(lits.cbegin(), lits.cend(), lit) != lits.cend())
+		{
+			continue;
+		}
+		lits.push_back(lit);
+	}
+
+	if (lits.empty())
+	{
+		_unsatisfiable = true;
+	}
+	else if (lits.size() == 1)
+	{
+		assign(lits[0], -1);
+		if (propagate() >= 0)
+		{
+			_unsatisfiable = true;
+		}
+	}
+	else
+	{
+		attachClause(lits);
+	}
+}
+
+int SatSolver::propagate()
+{
+	while (_propagated < _trail.size())
+	{
+		int falseLit = _trail[_propagated++] ^ 1;
+		vector<int> & watches = _watches[falseLit];
+
+		unsigned i = 0, j = 0;
+		for (; i < watches.size(); ++i)
+		{
+			int ci = watches[i];
+			vector<int> & clause = _clauses[ci];
+
+			// Make sure that the false literal is the second watch
+			if (clause[0] == falseLit)
+			{
+				swap(clause[0], clause[1]);
+			}
+
+			if (valueOf(clause[0]) == 1)
+			{
+				watches[j++] = ci;
+				continue;
+			}
+
+			// Look for a new literal to watch
+			bool found = false;
+			for (unsigned k = 2; k < clause.size(); ++k)
+			{
+				if (valueOf(clause[k]) != 0)
+				{
+					swap(clause[1], clause[k]);
+					_watches[clause[1]].push_back(ci);
+					found = true;
+					break;
+				}
+			}
+			if (found)
+			{
+				continue;
+			}
+
+			// The clause is unit or conflicting
+			watches[j++] = ci;
+			if (valueOf(clause[0]) == 0)
+			{
+				for (++i; i < watches.size(); ++i)
+				{
+					watches[j++] = watches[i];
+				}
+				watches.resize(j);
+				return ci;
+			}
+			assign(clause[0], ci);
+		}
+		watches.resize(j);
+	}
+
+	return -1;
+}
+
+void SatSolver::bumpActivity(int var)
+{
+	_activities[var] += _activityIncrement;
+	if (_activities[var] > 1e100)
+	{
+		for (double & activity : _activities)
+		{
+			activity *= 1e-100;
+		}
+		_activityIncrement *= 1e-100;
+	}
+}
+
+void SatSolver::analyze(int conflict, vector<int> & learnt, int & backtrackLevel)
+{
+	// First unique implication point learning
+	vector<bool> seen(_values.size(), false);
+	int currentLevel = _trailLimits.size();
+	int pathCount = 0;
+	int lit = -1;
+	unsigned index = _trail.size();
+
+	learnt.clear();
+	learnt.push_back(-1);
+
+	do
+	{
+		const vector<int> & clause = _clauses[conflict];
+		for (unsigned k = (lit == -1 ? 0 : 1); k < clause.size(); ++k)
+		{
+			int var = clause[k] >> 1;
+			if (seen[var] || _levels[var] == 0)
+			{
+				continue;
+			}
+
+			seen[var] = true;
+			bumpActivity(var);
+			if (_levels[var] == currentLevel)
+			{
+				++pathCount;
+			}
+			else
+			{
+				learnt.push_back(clause[k]);
+			}
+		}
+
+		// Walk back the trail to the next literal of the conflict
+		do
+		{
+			--index;
+		} while (!seen[_trail[index] >> 1]);
+
+		lit = _trail[index];
+		conflict = _reasons[lit >> 1];
+		seen[lit >> 1] = false;
+		--pathCount;
+	} while (pathCount > 0);
+
+	learnt[0] = lit ^ 1;
+
+	// The second watch is the literal of the highest remaining level
+	backtrackLevel = 0;
+	for (unsigned k = 1; k < learnt.size(); ++k)
+	{
+		if (_levels[learnt[k] >> 1] > backtrackLevel)
+		{
+			backtrackLevel = _levels[learnt[k] >> 1];
+			swap(learnt[1], learnt[k]);
+		}
+	}
+
+	_activityIncrement *= 1.05;
+}
+
+void SatSolver::backtrack(int level)
+{
+	if ((int)_trailLimits.size() <= level)
+	{
+		return;
+	}
+
+	for (unsigned i = _trail.size(); i > _trailLimits[level]; --i)
+	{
+		int var = _trail[i - 1] >> 1;
+		_phases[var] = _values[var] == 1;
+		_values[var] = -1;
+		_reasons[var] = -1;
+	}
+
+	_trail.resize(_trailLimits[level]);
+	_trailLimits.resize(level);
+	_propagated = _trail.size();
+}
+
+int SatSolver::pickBranchLiteral() const
+{
+	int best = -1;
+	for (unsigned var = 0; var < _values.size(); ++var)
+	{
+		if (_values[var] < 0 && (best < 0 || _activities[var] > _activities[best]))
+		{
+			best = var;
+		}
+	}
+
+	if (best < 0)
+	{
+		return -1;
+	}
+
+	// Phase saving: repeat the last value the variable had
+	return 2 * best + (_phases[best] ? 0 : 1);
+}
+
+bool SatSolver::solve(const CancellationToken & cancellation)
+{
+	if (_unsatisfiable)
+	{
+		return false;
+	}
+
+	vector<int> learnt;
+	int backtrackLevel;
+
+	while (true)
+	{
+		int conflict = propagate();
+		if (conflict >= 0)
+		{
+			if (_trailLimits.empty())
+			{
+				_unsatisfiable = true;
+				return false;
+			}
+
+			// A cancelled search gives up at a conflict, where the solver can go on later
+			if (cancellation.isCancelled())
+			{
+				backtrack(0);
+				return false;
+			}
+
+			analyze(conflict, learnt, backtrackLevel);
+			backtrack(backtrackLevel);
+
+			if (learnt.size() == 1)
+			{
+				assign(learnt[0], -1);
+			}
+			else
+			{
+				attachClause(learnt);
+				assign(learnt[0], _clauses.size() - 1);
+			}
+			continue;
+		}
+
+		int decision = pickBranchLiteral();
+		if (decision < 0)
+		{
+			// Every variable is assigned, so the model is complete
+			_model.assign(_values.size(), false);
+			for (unsigned var = 0; var < _values.size(); ++var)
+			{
+				_model[var] = _values[var] == 1;
+			}
+			backtrack(0);
+			return true;
+		}
+
+		_trailLimits.push_back(_trail.size());
+		assign(decision, -1);
+	}
+}
+
+bool SatSolver::getValue(int var) const
+{
+	return _model[var - 1];
+}
+
+// END SatSolver
+// ----------------------------------------------------------------------------
@@ -0,0 +1,53 @@
+#ifndef _SAT_H
+#define _SAT_H
+
+#include <vector>
+
+#include "cancellation.h"
+
+using namespace std;
+
+/* Literals are given in the DIMACS convention: the variable v (v >= 1) is the
+literal v, and its negation is the literal -v. */
+typedef int SatLiteral;
+
+class SatSolver
+{
+private:
+	// Internally, the literal of the variable v is 2 * v, and its negation is 2 * v + 1
+	vector< vector<int> > _clauses;
+	vector< vector<int> > _watches;
+	vector<signed char> _values;
+	vector<bool> _phases;
+	vector<bool> _model;
+	vector<int> _levels;
+	vector<int> _reasons;
+	vector<double> _activities;
+	vector<int> _trail;
+	vector<unsigned> _trailLimits;
+	unsigned _propagated;
+	double _activityIncrement;
+	bool _unsatisfiable;
+
+	signed char valueOf(int lit) const;
+	void assign(int lit, int reason);
+	int propagate();
+	void analyze(int conflict, vector<int> & learnt, int & backtrackLevel);
+	void backtrack(int level);
+	int pickBranchLiteral() const;
+	void attachClause(const vector<int> & clause);
+	void bumpActivity(int var);
+public:
+	SatSolver();
+
+	int newVariable();
+	unsigned getVariableCount() const;
+	// Clauses may be added before or between calls of solve
+	void addClause(const vector<SatLiteral> & clause);
+	// Also returns false if the token is cancelled before a model is found
+	bool solve(const CancellationToken & cancellation = CancellationToken());
+	// The value of the variable in the last model found by solve
+	bool getValue(int var) const;
+};
+
+#endif // _SAT_H
@@ -0,0 +1,171 @@
+#include "stdafx.h"
+#include "selftest.h"
+#include "prover.h"
+#include "session.h"
+#include "pratt.h"
+#include "parser.hpp"
+
+#include <random>
+#include <sstream>
+#include <vector>
+
+// How many random inputs are given to both parsers, half of them correct formulas
+static const unsigned PARSER_TEST_INPUTS = 20000;
+
+static Formula parseChecked(const string & text)
+{
+	string error;
+	Formula f = parseFormula(text, error);
+	if (f.get() == 0)
+	{
+		throw "Not applicable: a formula of the self tests is not correct";
+	}
+	return f;
+}
+
+/* Asserts the formulas in a new session, and checks the conjecture, or
+the assertions alone if it is empty. */
+static bool checkSession(ostream & output, const vector<string> & assertions, const string & conjecture, const string & expected)
+{
+	TableauxOptions options;
+	options.trace = false;
+	ProverSession session(options);
+	for (const string & assertion : assertions)
+	{
+		session.assertFormula(parseChecked(assertion));
+	}
+
+	string result = session.check(conjecture.empty() ? Formula() : parseChecked(conjecture));
+	if (result == expected)
+	{
+		return true;
+	}
+
+	output << "session:";
+	for (const string & assertion : assertions)
+	{
+		output << " " << assertion << ";";
+	}
+	output << " check " << (conjecture.empty() ? "()" : conjecture) << " gave " << result << " instead of " << expected << endl;
+	return false;
+}
+
+static unsigned runSessionTests(ostream & output)
+{
+	unsigned failed = 0;
+
+	// The delta witnesses of the session must not be names of later formulas
+	failed += checkSession(output, { "?[X]:p(X)", "~p(sc0)" }, "", "NOT A TAUTOLOGY") ? 0 : 1;
+	failed += checkSession(output, { "?[X]:p(X)", "~p(sc0)" }, "q", "NOT A TAUTOLOGY") ? 0 : 1;
+	failed += checkSession(output, { "?[X]:p(X)" }, "p(sc0)", "NOT A TAUTOLOGY") ? 0 : 1;
+	failed += checkSession(output, { "?[X]:p(X)", "![X]:~p(X)" }, "", "TAUTOLOGY") ? 0 : 1;
+	return failed;
+}
+
+static string getRandomTerm(mt19937 & random, unsigned depth)
+{
+	static const char * const LEAVES[] = { "X", "Y", "a", "b" };
+	switch (depth == 0 ? 0 : random() % 3)
+	{
+		case 0:
+			return LEAVES[random() % 4];
+		case 1:
+			return "f(" + getRandomTerm(random, depth - 1) + ")";
+		default:
+			return "g(" + getRandomTerm(random, depth - 1) + "," + getRandomTerm(random, depth - 1) + ")";
+	}
+}
+
+// A correct formula, with the connectives written with and without the parentheses and spaces around them
+static string getRandomFormula(mt19937 & random, unsigned depth)
+{
+	static const char * const CONNECTIVES[] = { "&", "|", "=>", "<=>" };
+	static const char * const SPACES[] = { "", " " };
+	switch (depth == 0 ? random() % 4 : 4 + random() % 5)
+	{
+		case 0:
+			return random() % 2 == 0 ? "p" : "true";
+		case 1:
+			return "q(" + getRandomTerm(random, 2) + "," + getRandomTerm(random, 2) + ")";
+		case 2:
+			return getRandomTerm(random, 2) + SPACES[random() % 2] + "=" + SPACES[random() % 2] + getRandomTerm(random, 2);
+		case 3:
+			return getRandomTerm(random, 2) + " ~= " + getRandomTerm(random, 2);
+		case 4:
+			return "~" + getRandomFormula(random, depth - 1);
+		case 5:
+			return string(random() % 2 == 0 ? "!" : "?") + "[" + (random() % 2 == 0 ? "X" : "Y") + "]:" + getRandomFormula(random, depth - 1);
+		case 6:
+			return "(" + getRandomFormula(random, depth - 1) + ")";
+		default:
+		{
+			string space = SPACES[random() % 2];
+			return getRandomFormula(random, depth - 1) + space + CONNECTIVES[random() % 4] + space + getRandomFormula(random, depth - 1);
+		}
+	}
+}
+
+// Mostly wrong input, made of the tokens of the syntax and some other characters
+static string getRandomTokens(mt19937 & random)
+{
+	static const char * const TOKENS[] = { "p", "q(a)", "f(X)", "X", "a", "(", ")", ",", "&", "|", "=>", "<=>",
+		"~", "=", "~=", "!", "?", "[", "]", ":", "true", "false", " ", "p(", "#" };
+	string text;
+	unsigned count = 1 + random() % 12;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		text += TOKENS[random() % (sizeof(TOKENS) / sizeof(TOKENS[0]))];
+	}
+	return text;
+}
+
+/* Parses the formula with the Bison grammar and with the Pratt parser, which
+must give the same formula or both reject it. */
+static bool checkParsers(ostream & output, const string & formula)
+{
+	string text = formula + ";";
+	string bisonError, prattError;
+	Formula bison = parseFormulaBuffer(text.c_str(), text.size(), bisonError);
+	Formula pratt;
+	PrattParser parser(text.c_str(), text.size());
+	parser.parseNext(pratt, prattError);
+
+	ostringstream bisonText, prattText;
+	if (bison.get() != 0)
+	{
+		bison->printFormula(bisonText);
+	}
+	if (pratt.get() != 0)
+	{
+		pratt->printFormula(prattText);
+	}
+	if ((bison.get() == 0) == (pratt.get() == 0) && bisonText.str() == prattText.str())
+	{
+		return true;
+	}
+
+	output << "parser: " << text << " gave " << (bison.get() != 0 ? bisonText.str() : "the error " + bisonError)
+		<< " with parser.ypp and " << (pratt.get() != 0 ? prattText.str() : "the error " + prattError) << " with the Pratt parser" << endl;
+	return false;
+}
+
+static unsigned runParserTests(ostream & output)
+{
+	// The same inputs on every run, so that a failure can be repeated
+	mt19937 random(2017);
+	unsigned failed = 0;
+	for (unsigned i = 0; i < PARSER_TEST_INPUTS / 2; ++i)
+	{
+		failed += checkParsers(output, getRandomFormula(random, 1 + random() % 4)) ? 0 : 1;
+		failed += checkParsers(output, getRandomTokens(random)) ? 0 : 1;
+	}
+	return failed;
+}
+
+unsigned runSelfTests(ostream & output)
+{
+	unsigned failed = 0;
+	failed += runSessionTests(output);
+	failed += runParserTests(output);
+	return failed;
+}
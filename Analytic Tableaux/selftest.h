@@ -0,0 +1,15 @@
+#ifndef _SELFTEST_H
+#define _SELFTEST_H
+
+#include <iostream>
+
+#include "fol.hpp"
+
+/* Runs the checks built into the program: the cases which once went wrong,
+and a comparison of the Pratt parser with the Bison grammar of parser.ypp on
+random input, which keeps the grammar the reference for the syntax. Every
+check that fails is written to the output, and the number of failed checks
+is returned. */
+unsigned runSelfTests(ostream & output);
+
+#endif // _SELFTEST_H
@@ -0,0 +1,363 @@
+#include "stdafx.h"
+#include "server.h"
+#include "threadpool.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "Ws2_32.lib")
+typedef SOCKET Socket;
+#else
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int Socket;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/* A client connection. The answers are written by the worker threads,
+and the socket is closed when the client is gone and all its proofs are done. */
+struct Connection
+{
+	Socket socket;
+	mutex writeMutex;
+	mutex pendingMutex;
+	condition_variable pendingCondition;
+	unsigned pending;
+	// The tokens of the pending proofs by their numbers, so that the client can cancel them
+	map<unsigned, CancellationToken> cancellations;
+};
+
+static bool isBlank(const string & s)
+{
+	return s.find_first_not_of(" \t\r\n") == string::npos;
+}
+
+static void writeAnswer(Connection & connection, const string & answer)
+{
+	lock_guard<mutex> lock(connection.writeMutex);
+
+	size_t sent = 0;
+	while (sent < answer.size())
+	{
+		int n = send(connection.socket, answer.c_str() + sent, (int)(answer.size() - sent), MSG_NOSIGNAL);
+		if (n <= 0)
+		{
+			// The client has gone away, the answer is dropped
+			return;
+		}
+		sent += n;
+	}
+}
+
+static string formatAnswer(unsigned index, const string & result, double milliseconds, const string & error)
+{
+	ostringstream answer;
+	answer << index << '\t' << result << '\t' << fixed << setprecision(3) << milliseconds;
+	if (!error.empty())
+	{
+		answer << '\t' << error;
+	}
+	answer << '\n';
+	return answer.str();
+}
+
+/* Reads the options at the beginning of the request. Returns false and
+sets the error if an option is not correct. */
+static bool readRequestOptions(istringstream & request, Engine & engine, TableauxOptions & options, string & error)
+{
+	while (true)
+	{
+		request >> ws;
+		if (request.peek() != '-')
+		{
+			return true;
+		}
+
+		string option;
+		request >> option;
+		if (option == "--simplify")
+		{
+			options.simplifyBranches = true;
+		}
+		else if (option == "--lookahead")
+		{
+			options.betaSelection = TableauxOptions::BS_LOOKAHEAD;
+		}
+		else if (option == "--models")
+		{
+			options.findModels = true;
+		}
+		else if (option == "--trace")
+		{
+			options.trace = true;
+		}
+		else if (option == "--engine")
+		{
+			string name;
+			request >> name;
+			if (!parseEngine(name, engine))
+			{
+				error = "unknown engine";
+				return false;
+			}
+		}
+		else if (option == "--timeout")
+		{
+			long timeLimit = -1;
+			request >> timeLimit;
+			if (request.fail() || timeLimit < 0)
+			{
+				error = "wrong timeout";
+				return false;
+			}
+			options.timeLimit = timeLimit;
+		}
+		else
+		{
+			error = "unknown option";
+			return false;
+		}
+	}
+}
+
+static void serveRequest(shared_ptr<Connection> connection, const string & line, unsigned index, ThreadPool & pool, Engine engine, TableauxOptions options)
+{
+	istringstream request(line);
+	string error;
+	options.trace = false;
+
+	if (!readRequestOptions(request, engine, options, error))
+	{
+		writeAnswer(*connection, formatAnswer(index, "ERROR", 0, error));
+		return;
+	}
+
+	string text((istreambuf_iterator<char>(request)), istreambuf_iterator<char>());
+
+	Formula f = parseFormula(text, error);
+	if (f.get() == 0)
+	{
+		writeAnswer(*connection, formatAnswer(index, "ERROR", 0, error));
+		return;
+	}
+
+	options.cancellation = CancellationToken::create();
+	{
+		lock_guard<mutex> lock(connection->pendingMutex);
+		connection->pending++;
+		connection->cancellations[index] = options.cancellation;
+	}
+
+	pool.submit([connection, f, index, engine, options]
+	{
+		TableauxOptions proofOptions = options;
+		ostringstream trace;
+		proofOptions.traceOutput = &trace;
+
+		string result;
+		string error;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		try
+		{
+			result = proveFormula(f, engine, proofOptions);
+		}
+		catch (const char * message)
+		{
+			result = "ERROR";
+			error = message;
+		}
+		// Out of memory, for example; only this request fails, and not the whole server
+		catch (const exception & e)
+		{
+			result = "ERROR";
+			error = e.what();
+		}
+		catch (...)
+		{
+			result = "ERROR";
+			error = "unknown error";
+		}
+		chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+		if (result == "UNKNOWN" && options.cancellation.isCancelled())
+		{
+			error = "cancelled";
+		}
+
+		string answer;
+		if (proofOptions.trace)
+		{
+			string text = trace.str();
+			answer = to_string(index) + "\tTRACE\t" + to_string(text.size()) + "\n" + text;
+		}
+		answer += formatAnswer(index, result, elapsed.count(), error);
+		writeAnswer(*connection, answer);
+
+		{
+			lock_guard<mutex> lock(connection->pendingMutex);
+			connection->pending--;
+			connection->cancellations.erase(index);
+		}
+		connection->pendingCondition.notify_all();
+	});
+}
+
+/* Handles the line "--cancel N", which cancels the pending proof number N
+of the connection and has no number and no answer of its own; the proof
+answers UNKNOWN with the error "cancelled". Returns false for other lines. */
+static bool serveCancel(Connection & connection, const string & line)
+{
+	istringstream request(line);
+	string option;
+	request >> option;
+	if (option != "--cancel")
+	{
+		return false;
+	}
+
+	unsigned index = 0;
+	request >> index;
+	lock_guard<mutex> lock(connection.pendingMutex);
+	map<unsigned, CancellationToken>::const_iterator iter = connection.cancellations.find(index);
+	if (iter != connection.cancellations.end())
+	{
+		iter->second.cancel();
+	}
+	return true;
+}
+
+static void serveConnection(Socket client, ThreadPool & pool, Engine engine, const TableauxOptions & options)
+{
+	shared_ptr<Connection> connection = make_shared<Connection>();
+	connection->socket = client;
+	connection->pending = 0;
+
+	string buffer;
+	char data[4096];
+	unsigned index = 0;
+	int n;
+
+	while ((n = recv(client, data, sizeof(data), 0)) > 0)
+	{
+		buffer.append(data, n);
+
+		size_t end;
+		while ((end = buffer.find('\n')) != string::npos)
+		{
+			string line = buffer.substr(0, end);
+			buffer.erase(0, end + 1);
+			if (!isBlank(line) && !serveCancel(*connection, line))
+			{
+				serveRequest(connection, line, ++index, pool, engine, options);
+			}
+		}
+	}
+
+	// A last request without its new line
+	if (!isBlank(buffer) && !serveCancel(*connection, buffer))
+	{
+		serveRequest(connection, buffer, ++index, pool, engine, options);
+	}
+
+	{
+		unique_lock<mutex> lock(connection->pendingMutex);
+		connection->pendingCondition.wait(lock, [&connection] { return connection->pending == 0; });
+	}
+	closesocket(client);
+}
+
+// Removes the socket at the path, if there is one; returns false if something else is there
+static bool removeSocketFile(const string & path)
+{
+#ifdef _WIN32
+	// The sockets are reparse points
+	DWORD attributes = GetFileAttributesA(path.c_str());
+	if (attributes == INVALID_FILE_ATTRIBUTES)
+	{
+		return true;
+	}
+	return (attributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0 && DeleteFileA(path.c_str()) != 0;
+#else
+	struct stat status;
+	if (lstat(path.c_str(), &status) != 0)
+	{
+		return errno == ENOENT;
+	}
+	return S_ISSOCK(status.st_mode) && unlink(path.c_str()) == 0;
+#endif
+}
+
+int runServer(const string & socketPath, Engine engine, const TableauxOptions & options, unsigned jobs)
+{
+#ifdef _WIN32
+	WSADATA wsaData;
+	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+	{
+		cerr << "Cannot start the sockets!" << endl;
+		return EXIT_FAILURE;
+	}
+#endif
+
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (socketPath.size() >= sizeof(address.sun_path))
+	{
+		cerr << "The socket path is too long!" << endl;
+		return EXIT_FAILURE;
+	}
+	strcpy(address.sun_path, socketPath.c_str());
+
+	Socket server = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server == INVALID_SOCKET)
+	{
+		cerr << "Cannot create the socket!" << endl;
+		return EXIT_FAILURE;
+	}
+
+	// A socket left behind by an earlier server is replaced, but nothing else is
+	if (!removeSocketFile(socketPath))
+	{
+		cerr << "Cannot listen on " << socketPath << "!" << endl;
+		closesocket(server);
+		return EXIT_FAILURE;
+	}
+	if (bind(server, (sockaddr *)&address, sizeof(address)) != 0 || listen(server, SOMAXCONN) != 0)
+	{
+		cerr << "Cannot listen on " << socketPath << "!" << endl;
+		closesocket(server);
+		return EXIT_FAILURE;
+	}
+
+	ThreadPool pool(jobs);
+	cerr << "Listening on " << socketPath << endl;
+
+	while (true)
+	{
+		Socket client = accept(server, 0, 0);
+		if (client == INVALID_SOCKET)
+		{
+			break;
+		}
+		thread(serveConnection, client, ref(pool), engine, options).detach();
+	}
+
+	closesocket(server);
+	removeSocketFile(socketPath);
+	return EXIT_FAILURE;
+}
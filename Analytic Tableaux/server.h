@@ -0,0 +1,26 @@
+#ifndef _SERVER_H
+#define _SERVER_H
+
+#include <string>
+
+#include "prover.h"
+
+/* Runs the prover as a server on a local (Unix domain) socket, so that
+formulas can be proved without starting a new process for each of them.
+
+Every request is a single line: options followed by a formula terminated by ';'.
+The options are the same as on the command line and apply only to that request:
+	--engine <name>, --simplify, --lookahead, --models, --timeout <milliseconds>, --trace
+The requests on a connection are numbered from 1. For each request one line is
+sent back as soon as its proof is done, so the answers may come in a different
+order than the requests:
+	<number> TAB <TAUTOLOGY, NOT A TAUTOLOGY, UNKNOWN or ERROR> TAB <milliseconds> [TAB <error>]
+With --trace, the answer is preceded by the line <number> TAB TRACE TAB <length>
+followed by that many bytes of the tableaux.
+
+The formulas are proved on the given number of worker threads. The engine and
+options are the defaults for the requests. The function only returns if the
+socket cannot be used. */
+int runServer(const string & socketPath, Engine engine, const TableauxOptions & options, unsigned jobs);
+
+#endif // _SERVER_H
@@ -0,0 +1,140 @@
+#include "stdafx.h"
+#include "session.h"
+#include "congruence.h"
+
+static bool containsSignedFormula(const deque<SignedFormula> & d_formulae, const Formula & f, bool sign)
+{
+	for (const SignedFormula & sf : d_formulae)
+	{
+		if (sf->getSign() == sign && sf->getFormula()->equalTo(f))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// ----------------------------------------------------------------------------
+// ProverSession
+
+ProverSession::ProverSession(const TableauxOptions & options)
+	:_options(options), _levels(1), _nextConstant(0)
+{}
+
+void ProverSession::assertFormula(const Formula & f)
+{
+	Level & level = _levels.back();
+	expand(level, make_shared<BaseSignedFormula>(prepareForTableaux(f), true));
+
+	// Unsatisfiable assertions stay unsatisfiable whatever is added to them
+	level.result = level.closed ? "TAUTOLOGY" : "";
+}
+
+void ProverSession::expand(Level & level, const SignedFormula & f)
+{
+	deque<SignedFormula> d_pending(1, f);
+
+	while (!d_pending.empty())
+	{
+		SignedFormula sf = d_pending.front();
+		d_pending.pop_front();
+
+		if (containsSignedFormula(level.prefix.formulae, sf->getFormula(), sf->getSign()))
+		{
+			continue;
+		}
+
+		switch (sf->getType())
+		{
+			case BaseSignedFormula::TT_ALPHA:
+			{
+				SignedFormula component1, component2;
+				sf->getAlphaComponents(component1, component2);
+				d_pending.push_back(component1);
+				if (component2.get() != 0)
+				{
+					d_pending.push_back(component2);
+				}
+				break;
+			}
+			case BaseSignedFormula::TT_DELTA:
+			{
+				// The delta rule is applied once and for all with a new constant
+				FunctionSymbol newConstant = getUniqueConstantSymbol();
+				Quantifier * pQuantifier = (Quantifier *)sf->getFormula().get();
+				Formula instFormula = sf->getFormula()->instantiate(pQuantifier->getVariable(), make_shared<FunctionTerm>(newConstant));
+				d_pending.push_back(make_shared<BaseSignedFormula>(instFormula, sf->getSign()));
+				level.prefix.constants.push_back(newConstant);
+				break;
+			}
+			default:
+			{
+				// Atoms, and the beta and gamma formulae which are left for the tableaux
+				if (sf->getType() == BaseSignedFormula::TT_ATOM && containsSignedFormula(level.prefix.formulae, sf->getFormula(), !sf->getSign()))
+				{
+					level.closed = true;
+				}
+				level.prefix.formulae.push_back(sf);
+				sf->getFormula()->getConstants(level.prefix.constants);
+				level.prefix.hasEquality = level.prefix.hasEquality || containsEquality(sf->getFormula());
+				break;
+			}
+		}
+	}
+}
+
+FunctionSymbol ProverSession::getUniqueConstantSymbol()
+{
+	// No parser gives a name with '$', so a formula asserted later cannot use the constant;
+	// the constants are not taken again after a pop, so they never meet an old instance
+	return "$sc" + to_string(_nextConstant++);
+}
+
+void ProverSession::push()
+{
+	Level level = _levels.back();
+	_levels.push_back(level);
+}
+
+bool ProverSession::pop()
+{
+	if (_levels.size() == 1)
+	{
+		return false;
+	}
+	_levels.pop_back();
+	return true;
+}
+
+unsigned ProverSession::getLevel() const
+{
+	return _levels.size() - 1;
+}
+
+string ProverSession::check(const Formula & conjecture)
+{
+	Level & level = _levels.back();
+
+	// Anything follows from unsatisfiable assertions
+	if (level.closed)
+	{
+		return "TAUTOLOGY";
+	}
+	if (conjecture.get() == 0 && !level.result.empty())
+	{
+		return level.result;
+	}
+
+	Tableaux t(level.prefix, conjecture, _options);
+	string result = t.getResult();
+
+	if (conjecture.get() == 0 && result != "UNKNOWN")
+	{
+		level.result = result;
+		level.closed = result == "TAUTOLOGY";
+	}
+	return result;
+}
+
+// END ProverSession
+// ----------------------------------------------------------------------------
@@ -0,0 +1,59 @@
+#ifndef _SESSION_H
+#define _SESSION_H
+
+#include <string>
+#include <vector>
+
+#include "fol.hpp"
+#include "tableaux.h"
+
+/* An incremental prover session. Formulas are asserted one at a time, and
+push and pop mark and retract a group of assertions, so that one hypothesis
+after another can be checked against the same assertions. An asserted
+formula is put on the branch at once with its alpha and delta rules applied,
+so the tableaux of every check starts from that prefix. Only this work is
+kept between checks: the beta and gamma formulae of the assertions are put on
+the prefix as they are, and every check splits and instantiates them again
+in a new tableaux. A complementary pair of literals among the assertions is
+found as they are asserted. A check is not repeated while nothing is
+asserted, and once the assertions are unsatisfiable, the checks after any
+further assertions are answered without a tableaux. */
+class ProverSession
+{
+private:
+	struct Level
+	{
+		TableauxPrefix prefix;
+		// A literal and its complement are both on the prefix
+		bool closed = false;
+		// The result of the check without a conjecture, empty until it is known
+		string result;
+	};
+
+	TableauxOptions _options;
+	// Each push adds a level, which starts as a copy of the one below it
+	vector<Level> _levels;
+	// The counter from which new constants for the delta rules are made
+	unsigned _nextConstant;
+
+	void expand(Level & level, const SignedFormula & f);
+	FunctionSymbol getUniqueConstantSymbol();
+public:
+	ProverSession(const TableauxOptions & options = TableauxOptions());
+
+	/* Adds the formula to the assertions. (It cannot be named assert,
+	which is a macro.) */
+	void assertFormula(const Formula & f);
+	void push();
+	// Retracts the assertions since the matching push; returns false if there was no push
+	bool pop();
+	// The number of pushes not yet popped
+	unsigned getLevel() const;
+
+	/* Proves that the conjecture follows from the assertions, with the same
+	result as the tableaux; without a conjecture it is proved that the
+	assertions are unsatisfiable. */
+	string check(const Formula & conjecture = Formula());
+};
+
+#endif // _SESSION_H
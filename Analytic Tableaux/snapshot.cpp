@@ -0,0 +1,536 @@
+#include "stdafx.h"
+#include "snapshot.h"
+
+#include <cstring>
+#include <fstream>
+
+static const char SNAPSHOT_MAGIC[8] = { 'A', 'T', 'S', 'N', 'A', 'P', '\r', '\n' };
+static const uint32_t SNAPSHOT_VERSION = 1;
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+/* The kinds of the formula nodes, which are part of the format. The fields
+a, b and c are: the symbol, the argument count and the first argument for
+the atoms; the left and the right side (as arguments) for equalities and
+disequalities; the operand for a negation; both operands for the binary
+connectives; and the variable symbol and the operand for the quantifiers. */
+enum SnapshotKind
+{
+	SK_TRUE, SK_FALSE, SK_ATOM, SK_EQUALITY, SK_DISEQUALITY,
+	SK_NOT, SK_AND, SK_OR, SK_IMP, SK_IFF, SK_FORALL, SK_EXISTS
+};
+
+enum SnapshotTermKind
+{
+	STK_VARIABLE, STK_FUNCTION
+};
+
+// ----------------------------------------------------------------------------
+// SnapshotWriter
+
+/* Collects the nodes of the formulas, each distinct node only once. */
+class SnapshotWriter
+{
+public:
+	struct Record
+	{
+		uint32_t kind;
+		uint32_t a;
+		uint32_t b;
+		uint32_t c;
+	};
+
+	vector<string> symbols;
+	vector<Record> terms;
+	vector<uint32_t> arguments;
+	vector<Record> formulas;
+	vector<uint32_t> roots;
+private:
+	unordered_map<string, uint32_t> _symbolIndexes;
+	unordered_map<string, uint32_t> _termIndexes;
+	unordered_map<string, uint32_t> _formulaIndexes;
+
+	static string getKey(uint32_t kind, uint32_t a, const vector<uint32_t> & operands);
+	uint32_t addArguments(const vector<uint32_t> & operands);
+	uint32_t addNode(vector<Record> & nodes, unordered_map<string, uint32_t> & indexes, const string & key, const Record & record);
+public:
+	uint32_t addSymbol(const string & symbol);
+	uint32_t addTerm(const Term & t);
+	uint32_t addFormula(const Formula & f);
+};
+
+string SnapshotWriter::getKey(uint32_t kind, uint32_t a, const vector<uint32_t> & operands)
+{
+	string key((const char *)&kind, sizeof(kind));
+	key.append((const char *)&a, sizeof(a));
+	for (uint32_t operand : operands)
+	{
+		key.append((const char *)&operand, sizeof(operand));
+	}
+	return key;
+}
+
+uint32_t SnapshotWriter::addArguments(const vector<uint32_t> & operands)
+{
+	uint32_t first = arguments.size();
+	arguments.insert(arguments.end(), operands.begin(), operands.end());
+	return first;
+}
+
+uint32_t SnapshotWriter::addNode(vector<Record> & nodes, unordered_map<string, uint32_t> & indexes, const string & key, const Record & record)
+{
+	unordered_map<string, uint32_t>::const_iterator iter = indexes.find(key);
+	if (iter != indexes.end())
+	{
+		return iter->second;
+	}
+
+	uint32_t index = nodes.size();
+	nodes.push_back(record);
+	indexes[key] = index;
+	return index;
+}
+
+uint32_t SnapshotWriter::addSymbol(const string & symbol)
+{
+	unordered_map<string, uint32_t>::const_iterator iter = _symbolIndexes.find(symbol);
+	if (iter != _symbolIndexes.end())
+	{
+		return iter->second;
+	}
+
+	uint32_t index = symbols.size();
+	symbols.push_back(symbol);
+	_symbolIndexes[symbol] = index;
+	return index;
+}
+
+uint32_t SnapshotWriter::addTerm(const Term & t)
+{
+	if (t->getType() == BaseTerm::TT_VARIABLE)
+	{
+		uint32_t symbol = addSymbol(((VariableTerm *)t.get())->getVariable());
+		return addNode(terms, _termIndexes, getKey(STK_VARIABLE, symbol, vector<uint32_t>()), Record{ STK_VARIABLE, symbol, 0, 0 });
+	}
+
+	// The arguments come before the term, so their indexes are smaller
+	FunctionTerm * pFunction = (FunctionTerm *)t.get();
+	vector<uint32_t> operands;
+	for (const Term & operand : pFunction->getOperands())
+	{
+		operands.push_back(addTerm(operand));
+	}
+
+	uint32_t symbol = addSymbol(pFunction->getSymbol());
+	string key = getKey(STK_FUNCTION, symbol, operands);
+	unordered_map<string, uint32_t>::const_iterator iter = _termIndexes.find(key);
+	if (iter != _termIndexes.end())
+	{
+		return iter->second;
+	}
+	return addNode(terms, _termIndexes, key, Record{ STK_FUNCTION, symbol, (uint32_t)operands.size(), addArguments(operands) });
+}
+
+uint32_t SnapshotWriter::addFormula(const Formula & f)
+{
+	vector<uint32_t> operands;
+	Record record = { 0, 0, 0, 0 };
+
+	switch (f->getType())
+	{
+		case BaseFormula::T_TRUE:
+			record.kind = SK_TRUE;
+			break;
+		case BaseFormula::T_FALSE:
+			record.kind = SK_FALSE;
+			break;
+		case BaseFormula::T_ATOM:
+		{
+			Atom * pAtom = (Atom *)f.get();
+			for (const Term & operand : pAtom->getOperands())
+			{
+				operands.push_back(addTerm(operand));
+			}
+
+			bool binary = operands.size() == 2;
+			if (binary && pAtom->getSymbol() == "=")
+			{
+				record.kind = SK_EQUALITY;
+			}
+			else if (binary && pAtom->getSymbol() == "~=")
+			{
+				record.kind = SK_DISEQUALITY;
+			}
+			else
+			{
+				record.kind = SK_ATOM;
+				record.a = addSymbol(pAtom->getSymbol());
+			}
+			break;
+		}
+		case BaseFormula::T_NOT:
+			record.kind = SK_NOT;
+			operands.push_back(addFormula(((Not *)f.get())->getOperand()));
+			break;
+		case BaseFormula::T_AND:
+		case BaseFormula::T_OR:
+		case BaseFormula::T_IMP:
+		case BaseFormula::T_IFF:
+		{
+			BinaryConjective * pBinary = (BinaryConjective *)f.get();
+			BaseFormula::Type type = f->getType();
+			record.kind = type == BaseFormula::T_AND ? SK_AND : type == BaseFormula::T_OR ? SK_OR : type == BaseFormula::T_IMP ? SK_IMP : SK_IFF;
+			operands.push_back(addFormula(pBinary->getOperand1()));
+			operands.push_back(addFormula(pBinary->getOperand2()));
+			break;
+		}
+		case BaseFormula::T_FORALL:
+		case BaseFormula::T_EXISTS:
+		{
+			Quantifier * pQuantifier = (Quantifier *)f.get();
+			record.kind = f->getType() == BaseFormula::T_FORALL ? SK_FORALL : SK_EXISTS;
+			record.a = addSymbol(pQuantifier->getVariable());
+			operands.push_back(addFormula(pQuantifier->getOperand()));
+			break;
+		}
+	}
+
+	// The arguments of an atom are added only for a new atom
+	string key = getKey(record.kind, record.a, operands);
+	unordered_map<string, uint32_t>::const_iterator iter = _formulaIndexes.find(key);
+	if (iter != _formulaIndexes.end())
+	{
+		return iter->second;
+	}
+
+	switch (record.kind)
+	{
+		case SK_ATOM:
+			record.b = operands.size();
+			record.c = addArguments(operands);
+			break;
+		case SK_EQUALITY:
+		case SK_DISEQUALITY:
+			record.a = operands[0];
+			record.b = operands[1];
+			break;
+		case SK_NOT:
+			record.a = operands[0];
+			break;
+		case SK_FORALL:
+		case SK_EXISTS:
+			record.b = operands[0];
+			break;
+		case SK_TRUE:
+		case SK_FALSE:
+			break;
+		default:
+			record.a = operands[0];
+			record.b = operands[1];
+			break;
+	}
+	return addNode(formulas, _formulaIndexes, key, record);
+}
+
+// END SnapshotWriter
+// ----------------------------------------------------------------------------
+
+static uint64_t writeSection(ofstream & outfile, uint64_t offset, const void * data, size_t size)
+{
+	// Every section starts on 8 bytes
+	static const char padding[8] = { 0 };
+	uint64_t start = (offset + 7) & ~(uint64_t)7;
+	outfile.write(padding, start - offset);
+	if (size > 0)
+	{
+		outfile.write((const char *)data, size);
+	}
+	return start;
+}
+
+bool writeFormulaSnapshot(const string & path, const vector<Formula> & formulas, string & error)
+{
+	SnapshotWriter writer;
+	for (const Formula & f : formulas)
+	{
+		writer.roots.push_back(writer.addFormula(f));
+	}
+
+	vector<uint32_t> symbolRecords;
+	string strings;
+	for (const string & symbol : writer.symbols)
+	{
+		symbolRecords.push_back(strings.size());
+		symbolRecords.push_back(symbol.size());
+		strings += symbol;
+	}
+
+	ofstream outfile(path.c_str(), ios::binary | ios::trunc);
+	if (!outfile.good())
+	{
+		error = "cannot write " + path;
+		return false;
+	}
+
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SNAPSHOT_VERSION;
+	header.byteOrder = SNAPSHOT_BYTE_ORDER;
+	header.symbolCount = writer.symbols.size();
+	header.termCount = writer.terms.size();
+	header.argumentCount = writer.arguments.size();
+	header.formulaCount = writer.formulas.size();
+	header.rootCount = writer.roots.size();
+
+	// The header is written again when the offsets are known
+	uint64_t offset = sizeof(header);
+	outfile.write((const char *)&header, sizeof(header));
+	header.symbolsOffset = writeSection(outfile, offset, symbolRecords.data(), symbolRecords.size() * sizeof(uint32_t));
+	offset = header.symbolsOffset + symbolRecords.size() * sizeof(uint32_t);
+	header.stringsOffset = writeSection(outfile, offset, strings.data(), strings.size());
+	header.stringsSize = strings.size();
+	offset = header.stringsOffset + strings.size();
+	header.termsOffset = writeSection(outfile, offset, writer.terms.data(), writer.terms.size() * sizeof(SnapshotWriter::Record));
+	offset = header.termsOffset + writer.terms.size() * sizeof(SnapshotWriter::Record);
+	header.argumentsOffset = writeSection(outfile, offset, writer.arguments.data(), writer.arguments.size() * sizeof(uint32_t));
+	offset = header.argumentsOffset + writer.arguments.size() * sizeof(uint32_t);
+	header.formulasOffset = writeSection(outfile, offset, writer.formulas.data(), writer.formulas.size() * sizeof(SnapshotWriter::Record));
+	offset = header.formulasOffset + writer.formulas.size() * sizeof(SnapshotWriter::Record);
+	header.rootsOffset = writeSection(outfile, offset, writer.roots.data(), writer.roots.size() * sizeof(uint32_t));
+
+	outfile.seekp(0);
+	outfile.write((const char *)&header, sizeof(header));
+	outfile.close();
+	if (!outfile.good())
+	{
+		error = "cannot write " + path;
+		return false;
+	}
+	return true;
+}
+
+bool isFormulaSnapshot(const string & path)
+{
+	ifstream infile(path.c_str(), ios::binary);
+	char magic[sizeof(SNAPSHOT_MAGIC)];
+	return infile.read(magic, sizeof(magic)) && memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+}
+
+// ----------------------------------------------------------------------------
+// FormulaSnapshot
+
+FormulaSnapshot::FormulaSnapshot()
+	:_header(0), _symbols(0), _strings(0), _termRecords(0), _arguments(0), _formulaRecords(0), _roots(0)
+{}
+
+const char * FormulaSnapshot::getSection(uint64_t offset, uint64_t count, size_t size) const
+{
+	uint64_t fileSize = _file.getSize();
+	if (offset % 8 != 0 || offset > fileSize || count > (fileSize - offset) / (size > 0 ? size : 1))
+	{
+		return 0;
+	}
+	return _file.getData() + offset;
+}
+
+bool FormulaSnapshot::open(const string & path, string & error)
+{
+	_terms.clear();
+	_formulas.clear();
+	_header = 0;
+
+	if (!_file.open(path))
+	{
+		error = "cannot open " + path;
+		return false;
+	}
+
+	const SnapshotHeader * header = (const SnapshotHeader *)_file.getData();
+	if (_file.getSize() < sizeof(SnapshotHeader) || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+	{
+		error = path + " is not a formula snapshot";
+		return false;
+	}
+	if (header->version != SNAPSHOT_VERSION || header->byteOrder != SNAPSHOT_BYTE_ORDER)
+	{
+		error = path + " is a snapshot of another version or byte order";
+		return false;
+	}
+
+	_header = header;
+	_symbols = (const SymbolRecord *)getSection(header->symbolsOffset, header->symbolCount, sizeof(SymbolRecord));
+	_strings = getSection(header->stringsOffset, header->stringsSize, 1);
+	_termRecords = (const NodeRecord *)getSection(header->termsOffset, header->termCount, sizeof(NodeRecord));
+	_arguments = (const uint32_t *)getSection(header->argumentsOffset, header->argumentCount, sizeof(uint32_t));
+	_formulaRecords = (const NodeRecord *)getSection(header->formulasOffset, header->formulaCount, sizeof(NodeRecord));
+	_roots = (const uint32_t *)getSection(header->rootsOffset, header->rootCount, sizeof(uint32_t));
+	if (_symbols == 0 || _strings == 0 || _termRecords == 0 || _arguments == 0 || _formulaRecords == 0 || _roots == 0)
+	{
+		_header = 0;
+		error = path + " is damaged";
+		return false;
+	}
+	return true;
+}
+
+unsigned FormulaSnapshot::getFormulaCount() const
+{
+	return _header != 0 ? _header->rootCount : 0;
+}
+
+string FormulaSnapshot::getSymbol(uint32_t index) const
+{
+	if (index >= _header->symbolCount || _symbols[index].offset > _header->stringsSize ||
+		_symbols[index].length > _header->stringsSize - _symbols[index].offset)
+	{
+		throw "Damaged snapshot: wrong symbol";
+	}
+	return string(_strings + _symbols[index].offset, _symbols[index].length);
+}
+
+bool FormulaSnapshot::getArguments(uint32_t first, uint32_t count, uint32_t parent, vector<Term> & arguments) const
+{
+	if (first > _header->argumentCount || count > _header->argumentCount - first)
+	{
+		return false;
+	}
+
+	for (uint32_t i = first; i < first + count; i++)
+	{
+		// The arguments of a term come before it; parent is the term count for an atom
+		if (_arguments[i] >= parent)
+		{
+			return false;
+		}
+		arguments.push_back(getTerm(_arguments[i]));
+	}
+	return true;
+}
+
+Term FormulaSnapshot::getTerm(uint32_t index) const
+{
+	unordered_map<uint32_t, Term>::const_iterator iter = _terms.find(index);
+	if (iter != _terms.end())
+	{
+		return iter->second;
+	}
+	if (index >= _header->termCount)
+	{
+		throw "Damaged snapshot: wrong term";
+	}
+
+	const NodeRecord & record = _termRecords[index];
+	Term t;
+	if (record.kind == STK_VARIABLE)
+	{
+		t = make_shared<VariableTerm>(getSymbol(record.a));
+	}
+	else
+	{
+		vector<Term> operands;
+		if (record.kind != STK_FUNCTION || !getArguments(record.c, record.b, index, operands))
+		{
+			throw "Damaged snapshot: wrong term";
+		}
+		t = make_shared<FunctionTerm>(getSymbol(record.a), move(operands));
+	}
+	_terms[index] = t;
+	return t;
+}
+
+Formula FormulaSnapshot::getNode(uint32_t index) const
+{
+	unordered_map<uint32_t, Formula>::const_iterator iter = _formulas.find(index);
+	if (iter != _formulas.end())
+	{
+		return iter->second;
+	}
+	if (index >= _header->formulaCount)
+	{
+		throw "Damaged snapshot: wrong formula";
+	}
+
+	// The operands come before the formula, so there are no cycles
+	const NodeRecord & record = _formulaRecords[index];
+	uint32_t operandCount = record.kind == SK_NOT || record.kind == SK_FORALL || record.kind == SK_EXISTS ? 1 :
+		record.kind >= SK_AND && record.kind <= SK_IFF ? 2 : 0;
+	uint32_t operand1 = record.kind == SK_FORALL || record.kind == SK_EXISTS ? record.b : record.a;
+	if ((operandCount >= 1 && operand1 >= index) || (operandCount == 2 && record.b >= index))
+	{
+		throw "Damaged snapshot: wrong formula";
+	}
+
+	Formula f;
+	switch (record.kind)
+	{
+		case SK_TRUE:
+			f = make_shared<True>();
+			break;
+		case SK_FALSE:
+			f = make_shared<False>();
+			break;
+		case SK_ATOM:
+		{
+			vector<Term> operands;
+			if (!getArguments(record.c, record.b, _header->termCount, operands))
+			{
+				throw "Damaged snapshot: wrong atom";
+			}
+			f = make_shared<Atom>(getSymbol(record.a), move(operands));
+			break;
+		}
+		case SK_EQUALITY:
+			f = make_shared<Equality>(getTerm(record.a), getTerm(record.b));
+			break;
+		case SK_DISEQUALITY:
+			f = make_shared<Disequality>(getTerm(record.a), getTerm(record.b));
+			break;
+		case SK_NOT:
+			f = make_shared<Not>(getNode(record.a));
+			break;
+		case SK_AND:
+			f = make_shared<And>(getNode(record.a), getNode(record.b));
+			break;
+		case SK_OR:
+			f = make_shared<Or>(getNode(record.a), getNode(record.b));
+			break;
+		case SK_IMP:
+			f = make_shared<Imp>(getNode(record.a), getNode(record.b));
+			break;
+		case SK_IFF:
+			f = make_shared<Iff>(getNode(record.a), getNode(record.b));
+			break;
+		case SK_FORALL:
+			f = make_shared<Forall>(getSymbol(record.a), getNode(record.b));
+			break;
+		case SK_EXISTS:
+			f = make_shared<Exists>(getSymbol(record.a), getNode(record.b));
+			break;
+		default:
+			throw "Damaged snapshot: unknown formula";
+	}
+	_formulas[index] = f;
+	return f;
+}
+
+Formula FormulaSnapshot::getFormula(unsigned index) const
+{
+	if (index >= getFormulaCount())
+	{
+		throw "Not applicable: no such formula in the snapshot";
+	}
+	return getNode(_roots[index]);
+}
+
+vector<Formula> FormulaSnapshot::getFormulas() const
+{
+	vector<Formula> formulas;
+	for (unsigned i = 0; i < getFormulaCount(); i++)
+	{
+		formulas.push_back(getFormula(i));
+	}
+	return formulas;
+}
+
+// END FormulaSnapshot
+// ----------------------------------------------------------------------------
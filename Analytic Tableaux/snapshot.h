@@ -0,0 +1,108 @@
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fol.hpp"
+#include "mappedfile.h"
+
+/* A binary snapshot of a set of formulas, usually premises already prepared
+for the tableaux, so that they need not be parsed and prepared again at every
+start. The symbols are interned in a table, and equal subterms and
+subformulas are stored only once, so the formulas form a DAG. Every node
+refers to its children by their index, which is always smaller than its own,
+so the file holds no pointers and is used as it is mapped into memory.
+
+The file is laid out as follows, all numbers in the byte order of the machine
+that wrote it (a file of the other byte order is rejected):
+	header		SnapshotHeader
+	symbols		symbolCount times { offset, length } into the strings
+	strings		the characters of all the symbols
+	terms		termCount times { kind, symbol, argument count, first argument }
+	arguments	the term indexes of the arguments of terms and atoms
+	formulas	formulaCount times { kind, a, b, c }, see SnapshotKind
+	roots		rootCount formula indexes, the formulas of the snapshot
+where every section starts at the offset given in the header. */
+struct SnapshotHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	uint32_t symbolCount;
+	uint32_t termCount;
+	uint32_t argumentCount;
+	uint32_t formulaCount;
+	uint32_t rootCount;
+	uint32_t reserved;
+	uint64_t symbolsOffset;
+	uint64_t stringsOffset;
+	uint64_t stringsSize;
+	uint64_t termsOffset;
+	uint64_t argumentsOffset;
+	uint64_t formulasOffset;
+	uint64_t rootsOffset;
+};
+
+/* Writes the formulas to a snapshot. Returns false and sets the error if
+the file cannot be written. */
+bool writeFormulaSnapshot(const string & path, const vector<Formula> & formulas, string & error);
+
+/* Checks whether the file starts like a snapshot. */
+bool isFormulaSnapshot(const string & path);
+
+/* A snapshot mapped into memory. Opening it only checks the header, so it
+takes the same short time for any number of formulas; a formula is built
+from the file the first time it is asked for, and the nodes shared with the
+formulas built before are shared in memory as well. The formulas are not
+built by several threads at once. */
+class FormulaSnapshot
+{
+private:
+	struct SymbolRecord
+	{
+		uint32_t offset;
+		uint32_t length;
+	};
+
+	struct NodeRecord
+	{
+		uint32_t kind;
+		uint32_t a;
+		uint32_t b;
+		uint32_t c;
+	};
+
+	MappedFile _file;
+	const SnapshotHeader * _header;
+	const SymbolRecord * _symbols;
+	const char * _strings;
+	// The terms are stored as { kind, symbol, argument count, first argument }
+	const NodeRecord * _termRecords;
+	const uint32_t * _arguments;
+	const NodeRecord * _formulaRecords;
+	const uint32_t * _roots;
+	mutable unordered_map<uint32_t, Term> _terms;
+	mutable unordered_map<uint32_t, Formula> _formulas;
+
+	const char * getSection(uint64_t offset, uint64_t count, size_t size) const;
+	string getSymbol(uint32_t index) const;
+	bool getArguments(uint32_t first, uint32_t count, uint32_t parent, vector<Term> & arguments) const;
+	Term getTerm(uint32_t index) const;
+	Formula getNode(uint32_t index) const;
+public:
+	FormulaSnapshot();
+
+	/* Maps the snapshot. Returns false and sets the error if it cannot be
+	read, or if it is not a snapshot of this version. */
+	bool open(const string & path, string & error);
+
+	unsigned getFormulaCount() const;
+	/* Builds the formula, or throws if the file is damaged. */
+	Formula getFormula(unsigned index) const;
+	vector<Formula> getFormulas() const;
+};
+
+#endif // _SNAPSHOT_H
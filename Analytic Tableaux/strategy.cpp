@@ -0,0 +1,60 @@
+#include "stdafx.h"
+#include "strategy.h"
+
+/* A row of the strategy table: when the condition holds, the strategy is
+used, written as for parsePortfolio. */
+struct StrategyRule
+{
+	const char * name;
+	bool (*applies)(const FormulaFeatures & features);
+	const char * strategy;
+};
+
+static const StrategyRule STRATEGY_TABLE[] =
+{
+	// The tableaux of a large propositional formula is too wide, while the SAT solver of Inst-Gen solves it at once
+	{ "large propositional", [](const FormulaFeatures & f) { return f.propositional && f.size > 200; }, "instgen" },
+	{ "propositional", [](const FormulaFeatures & f) { return f.propositional; }, "tableaux+lookahead+simplify" },
+	// Only the tableaux knows the equality, the other engines take it as any other predicate
+	{ "equality", [](const FormulaFeatures & f) { return f.hasEquality; }, "tableaux+lookahead" },
+	// Every equivalence doubles the formula for the tableaux, the clauses are fewer
+	{ "equivalences", [](const FormulaFeatures & f) { return f.iffCount >= 4; }, "instgen" },
+	// Without new constants or functions the ground tableaux has finitely many instances to try
+	{ "no delta", [](const FormulaFeatures & f) { return f.deltaPositions == 0 && f.maxFunctionArity == 0; }, "tableaux+lookahead" },
+	// Nested Skolem functions are unified by resolution, while Inst-Gen has to generate their instances
+	{ "alternations", [](const FormulaFeatures & f) { return f.alternationDepth >= 2; }, "resolution" },
+	// The ground tableaux may give up on a branch with functions too early, and resolution
+	// may saturate forever, while Inst-Gen still finds the propositional model
+	{ "functions", [](const FormulaFeatures & f) { return f.maxFunctionArity > 0; }, "instgen" },
+	{ "default", [](const FormulaFeatures & f) { (void)f; return true; }, "instgen" }
+};
+
+PortfolioStrategy selectStrategy(const Theory & premises, const Formula & conjecture, const TableauxOptions & options)
+{
+	FormulaFeatures features = premises.getFeatures();
+	features.add(conjecture, false);
+
+	for (const StrategyRule & rule : STRATEGY_TABLE)
+	{
+		if (!rule.applies(features))
+		{
+			continue;
+		}
+
+		vector<PortfolioStrategy> strategies;
+		if (!parsePortfolio(rule.strategy, strategies))
+		{
+			throw "Not applicable: wrong strategy in the strategy table";
+		}
+
+		// Only the heuristics come from the table
+		PortfolioStrategy strategy = strategies[0];
+		TableauxOptions heuristics = strategy.options;
+		strategy.name = string(rule.name) + ": " + rule.strategy;
+		strategy.options = options;
+		strategy.options.simplifyBranches = heuristics.simplifyBranches;
+		strategy.options.betaSelection = heuristics.betaSelection;
+		return strategy;
+	}
+	throw "Not applicable: no row of the strategy table applies";
+}
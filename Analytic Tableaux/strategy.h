@@ -0,0 +1,16 @@
+#ifndef _STRATEGY_H
+#define _STRATEGY_H
+
+#include "fol.hpp"
+#include "formulafeatures.h"
+#include "portfolio.h"
+#include "theory.h"
+
+/* Chooses the engine and the heuristics for proving the conjecture from the
+premises, by the first row of a built-in table whose condition holds for
+the features of the premises and the conjecture together. The strategy is
+named after the row, and its options are the given options with the
+heuristics of the row. */
+PortfolioStrategy selectStrategy(const Theory & premises, const Formula & conjecture, const TableauxOptions & options);
+
+#endif // _STRATEGY_H
@@ -1,7 +1,65 @@
 #include "stdafx.h"
 #include "tableaux.h"
+#include "theory.h"
+#include "modelfinder.h"
+
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+// The memory of the process is measured only after this many rule applications, as it takes a system call
+static const unsigned MEMORY_CHECK_INTERVAL = 256;
+
+// The terms in t, each after its arguments
+static void getSubterms(const Term & t, vector<Term> & terms)
+{
+	if (t->getType() == BaseTerm::TT_FUNCTION)
+	{
+		for (const Term & operand : ((FunctionTerm *)t.get())->getOperands())
+		{
+			getSubterms(operand, terms);
+		}
+	}
+	terms.push_back(t);
+}
 
-vector< deque<SignedFormula> > _nodes;
+static void getPredicateSymbols(const Formula & f, set<PredicateSymbol> & symbols)
+{
+	switch (f->getType())
+	{
+		case BaseFormula::T_ATOM:
+			symbols.insert(((Atom *)f.get())->getSymbol());
+			break;
+		case BaseFormula::T_NOT:
+			getPredicateSymbols(((Not *)f.get())->getOperand(), symbols);
+			break;
+		case BaseFormula::T_AND:
+		case BaseFormula::T_OR:
+		case BaseFormula::T_IMP:
+		case BaseFormula::T_IFF:
+		{
+			BinaryConjective * pBinary = (BinaryConjective *)f.get();
+			getPredicateSymbols(pBinary->getOperand1(), symbols);
+			getPredicateSymbols(pBinary->getOperand2(), symbols);
+			break;
+		}
+		case BaseFormula::T_FORALL:
+		case BaseFormula::T_EXISTS:
+			getPredicateSymbols(((Quantifier *)f.get())->getOperand(), symbols);
+			break;
+		default:
+			break;
+	}
+}
 
 // ----------------------------------------------------------------------------
 // BaseSignedFormula
@@ -23,8 +81,10 @@ void BaseSignedFormula::printSignedFormula(ostream & ostr) const
 
 BaseSignedFormula::TableauxType BaseSignedFormula::getType() const
 {
-	// We treat atoms as special type of formulae
-	if (_f->getType() == BaseFormula::T_ATOM)
+	// We treat atoms as special type of formulae, and so are the logic constants left behind by branch simplification
+	if (_f->getType() == BaseFormula::T_ATOM ||
+		_f->getType() == BaseFormula::T_TRUE ||
+		_f->getType() == BaseFormula::T_FALSE)
 	{
 		return TT_ATOM;
 	}
@@ -84,63 +144,370 @@ BaseSignedFormula::TableauxType BaseSignedFormula::getType() const
 	throw "Not applicable";
 }
 
+void BaseSignedFormula::getBetaComponents(SignedFormula & component1, SignedFormula & component2) const
+{
+	if (getType() != TT_BETA)
+	{
+		throw "Not applicable: getBetaComponents called for a non-beta signed formula";
+	}
+
+	BinaryConjective * pRule = (BinaryConjective *)_f.get();
+
+	// F (X /\ Y) splits into F X | F Y, T (X \/ Y) into T X | T Y and T (X => Y) into F X | T Y
+	component1 = make_shared<BaseSignedFormula>(pRule->getOperand1(), _f->getType() == BaseFormula::T_OR);
+	component2 = make_shared<BaseSignedFormula>(pRule->getOperand2(), _sign);
+}
+
+void BaseSignedFormula::getAlphaComponents(SignedFormula & component1, SignedFormula & component2) const
+{
+	if (getType() != TT_ALPHA)
+	{
+		throw "Not applicable: getAlphaComponents called for a non-alpha signed formula";
+	}
+
+	// T ~X gives F X, and F ~X gives T X
+	if (_f->getType() == BaseFormula::T_NOT)
+	{
+		component1 = make_shared<BaseSignedFormula>(((Not *)_f.get())->getOperand(), !_sign);
+		component2 = SignedFormula();
+		return;
+	}
+
+	BinaryConjective * pRule = (BinaryConjective *)_f.get();
+
+	// T (X /\ Y) gives T X and T Y, F (X \/ Y) gives F X and F Y, and F (X => Y) gives T X and F Y
+	component1 = make_shared<BaseSignedFormula>(pRule->getOperand1(), _f->getType() == BaseFormula::T_IMP || _sign);
+	component2 = make_shared<BaseSignedFormula>(pRule->getOperand2(), _sign);
+}
+
 // END BaseSignedFormula
 // ----------------------------------------------------------------------------
 
 // ----------------------------------------------------------------------------
 // Tableaux
 
-Tableaux::Tableaux(const Formula & root)
-{
-	// The original formula should be transformed to match the correct input for tableaux
-	Formula transformed;
+Tableaux::Tableaux(const Formula & root, const TableauxOptions & options)
+	:Tableaux(Theory(), root, options)
+{}
 
-	// First, eliminate all equivalents from the formula, and then eliminate all constants from the formula
-	transformed = root->releaseIff()->absorbConstants();
+Tableaux::Tableaux(const Theory & premises, const Formula & conjecture, const TableauxOptions & options)
+	:Tableaux(premises.getPrefix(), conjecture, options, &premises)
+{}
 
-	// If the transformed formula is a logic constant true, then...
-	if (transformed->getType() == BaseFormula::T_TRUE)
+Tableaux::Tableaux(const TableauxPrefix & prefix, const Formula & conjecture, const TableauxOptions & options)
+	:Tableaux(prefix, conjecture, options, nullptr)
+{}
+
+Tableaux::Tableaux(const TableauxPrefix & prefix, const Formula & conjecture, const TableauxOptions & options, const Theory * premises)
+	:_prefix(&prefix), _options(options), _limit(TL_NONE), _nextMemoryCheck(0), _nextConstant(0)
+{
+	_trace = _options.traceOutput != nullptr ? _options.traceOutput : &cout;
+	if (_options.certificateOutput != nullptr)
 	{
-		// ... transform the formula into its equivalent form without logic constants
-		transformed = ((True*)transformed.get())->transformToDisjunction();
+		_certificate.reset(new CertificateWriter(*_options.certificateOutput));
 	}
-	// If the transformed formula is a logic constant false, then...
-	else if (transformed->getType() == BaseFormula::T_FALSE)
+	_deadline = chrono::steady_clock::now() + chrono::milliseconds(_options.timeLimit);
+
+	_hasEquality = prefix.hasEquality;
+	if (conjecture.get() != 0)
 	{
-		// ... transform the formula into its equivalent form without logic constants
-		transformed = ((False*)transformed.get())->transformToConjunction();
+		// The original formula should be transformed to match the correct input for tableaux
+		Formula transformed = prepareForTableaux(conjecture);
+		_hasEquality = _hasEquality || containsEquality(transformed);
+		_root = make_shared<BaseSignedFormula>(transformed, false);
 	}
-	// Otherwise, do nothing
-
-	_root = make_shared<BaseSignedFormula>(transformed, false);
 	/* By here, the formula _root is equivalent to the beginning formula root,
 	so if the formula _root is unsatisfiable, then the formula root is unsatisfiable */
+	if (premises != nullptr && _options.findModels)
+	{
+		proveWithModelFinder(*premises, conjecture);
+	}
+	else
+	{
+		_result = prove();
+	}
+	_prefix = nullptr;
+
+	if (_certificate != nullptr)
+	{
+		_certificate->flush();
+	}
+}
+
+// The model finder runs on the clauses of the problem while this thread builds the tableaux
+void Tableaux::proveWithModelFinder(const Theory & premises, const Formula & conjecture)
+{
+	// Both sides are stopped by the token of the caller, and each side by the other one
+	CancellationToken finderCancellation = CancellationToken::create(_options.cancellation);
+	CancellationToken tableauxCancellation = CancellationToken::create(_options.cancellation);
+	_options.cancellation = tableauxCancellation;
+
+	string finiteModel;
+	thread finder([&]
+	{
+		try
+		{
+			vector<Clause> clauses = premises.getClauses();
+			if (conjecture.get() != 0)
+			{
+				Clausifier clausifier = premises.getClausifier();
+				vector<Clause> negated = clausifier.clausifyNegation(conjecture);
+				clauses.insert(clauses.end(), negated.begin(), negated.end());
+			}
+
+			ModelFinder modelFinder(clauses, finderCancellation);
+			if (modelFinder.isFound())
+			{
+				finiteModel = modelFinder.getModel();
+				tableauxCancellation.cancel();
+			}
+		}
+		catch (...)
+		{
+			// Without the model finder the tableaux still decides on its own
+		}
+	});
+
 	_result = prove();
+	finderCancellation.cancel();
+	finder.join();
+
+	// A finite model is a counter-model, whatever stopped the tableaux
+	if (!finiteModel.empty() && _limit != TL_NONE)
+	{
+		_limit = TL_NONE;
+		_result = false;
+		_finiteModel = finiteModel;
+	}
 }
 
 string Tableaux::getResult() const
 {
+	if (_limit != TL_NONE)
+	{
+		return "UNKNOWN";
+	}
 	return _result ? "TAUTOLOGY" : "NOT A TAUTOLOGY";
 }
 
+TableauxStatistics Tableaux::getStatistics() const
+{
+	return _statistics;
+}
+
+TableauxLimit Tableaux::getLimit() const
+{
+	return _limit;
+}
+
+string Tableaux::getCounterModel() const
+{
+	if (getResult() != "NOT A TAUTOLOGY")
+	{
+		return "";
+	}
+	if (!_finiteModel.empty())
+	{
+		return _finiteModel;
+	}
+
+	// The terms of the branch are grouped by the equalities on it, which were undone when the tableaux backtracked
+	CongruenceClosure congruence;
+	vector<Term> terms;
+	for (const FunctionSymbol & constant : _openConstants)
+	{
+		terms.push_back(make_shared<FunctionTerm>(constant));
+	}
+	for (const SignedFormula & sf : _openBranch)
+	{
+		if (sf->getFormula()->getType() == BaseFormula::T_ATOM)
+		{
+			congruence.assertLiteral(sf->getFormula(), sf->getSign());
+			for (const Term & operand : ((const Atom *)sf->getFormula().get())->getOperands())
+			{
+				getSubterms(operand, terms);
+			}
+		}
+	}
+
+	// The first term of a class stands for it; the constants come first, and the arguments before their terms
+	map<unsigned, Term> representatives;
+	set<string> written;
+	ostringstream domain, equalities;
+	for (const Term & t : terms)
+	{
+		ostringstream text;
+		t->printTerm(text);
+		if (!written.insert(text.str()).second)
+		{
+			continue;
+		}
+
+		unsigned c = congruence.getClass(t);
+		map<unsigned, Term>::const_iterator iter = representatives.find(c);
+		if (iter == representatives.end())
+		{
+			// A new class stands for itself, with the arguments written as the terms which stand for them
+			Term representative = t;
+			if (t->getType() == BaseTerm::TT_FUNCTION)
+			{
+				const FunctionTerm * pFunction = (const FunctionTerm *)t.get();
+				if (pFunction->getOperands().empty())
+				{
+					domain << (domain.tellp() == 0 ? "" : ", ") << text.str();
+				}
+				vector<Term> arguments;
+				for (const Term & operand : pFunction->getOperands())
+				{
+					arguments.push_back(representatives[congruence.getClass(operand)]);
+				}
+				representative = make_shared<FunctionTerm>(pFunction->getSymbol(), arguments);
+			}
+			representatives[c] = representative;
+			continue;
+		}
+
+		equalities << ", " << text.str() << " = ";
+		iter->second->printTerm(equalities);
+	}
+
+	ostringstream model;
+	model << "{" << domain.str() << "}";
+	string literals = equalities.str();
+
+	// The true atoms first; congruent atoms, and an atom simplified more than once, are written once
+	written.clear();
+	for (bool sign : { true, false })
+	{
+		for (const SignedFormula & sf : _openBranch)
+		{
+			if (sf->getSign() != sign || sf->getFormula()->getType() != BaseFormula::T_ATOM)
+			{
+				continue;
+			}
+
+			const Atom * pAtom = (const Atom *)sf->getFormula().get();
+			if (pAtom->getSymbol() == "=" || pAtom->getSymbol() == "~=")
+			{
+				continue;
+			}
+
+			vector<Term> arguments;
+			for (const Term & operand : pAtom->getOperands())
+			{
+				arguments.push_back(representatives[congruence.getClass(operand)]);
+			}
+			ostringstream literal;
+			literal << (sign ? "" : "~");
+			Atom(pAtom->getSymbol(), arguments).printFormula(literal);
+
+			if (written.insert(literal.str()).second)
+			{
+				literals += ", " + literal.str();
+			}
+		}
+	}
+
+	if (!literals.empty())
+	{
+		model << " " << literals.substr(2);
+	}
+	return model.str();
+}
+
+// The memory the process holds now, or 0 if it cannot be measured
+static size_t getProcessMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.WorkingSetSize;
+	}
+	return 0;
+#else
+	// The second number is the count of resident pages
+	ifstream statm("/proc/self/statm");
+	size_t pages, resident;
+	if (statm >> pages >> resident)
+	{
+		return resident * (size_t)sysconf(_SC_PAGESIZE);
+	}
+	return 0;
+#endif
+}
+
+bool Tableaux::isOutOfResources() const
+{
+	if (_limit != TL_NONE)
+	{
+		return true;
+	}
+
+	if (_options.cancellation.isCancelled())
+	{
+		_limit = TL_CANCELLED;
+	}
+	else if (_options.timeLimit != 0 && chrono::steady_clock::now() >= _deadline)
+	{
+		_limit = TL_TIME;
+	}
+	else if (_options.ruleLimit != 0 && _statistics.ruleApplications >= _options.ruleLimit)
+	{
+		_limit = TL_RULES;
+	}
+	else if (_options.memoryLimit != 0 && _statistics.ruleApplications >= _nextMemoryCheck)
+	{
+		_nextMemoryCheck = _statistics.ruleApplications + MEMORY_CHECK_INTERVAL;
+		size_t memory = getProcessMemory();
+		_statistics.peakMemory = max(_statistics.peakMemory, memory);
+		if (memory > _options.memoryLimit)
+		{
+			_limit = TL_MEMORY;
+		}
+	}
+	return _limit != TL_NONE;
+}
+
 bool Tableaux::prove(deque<SignedFormula>&& d_formulae, deque<FunctionSymbol>&& d_constants, int tabs) const
 {
+	// Out of resources every branch is taken as closed, so that the whole tableaux is left at once
+	if (isOutOfResources())
+	{
+		return true;
+	}
+
 	if (!d_formulae.empty())
 	{
 		// Writing the current state of tableaux to the standard output
-		cout << string(tabs, '\t');
-		cout << d_formulae << ", " << d_constants << endl;
+		if (_options.trace)
+		{
+			*_trace << string(tabs, '\t');
+			*_trace << d_formulae << ", " << d_constants << endl;
+		}
 
 		SignedFormula rule;
 		BaseSignedFormula::TableauxType tType;
+		SignedFormula closingFirst, closingSecond;
 
-		if (checkIfExistsComplementaryPairOfLiterals(d_formulae))
+		if (checkIfExistsComplementaryPairOfLiterals(d_formulae, closingFirst, closingSecond))
 		{
 			// close the branch
+			_statistics.closedBranches++;
+			if (_certificate != nullptr && closingFirst.get() == 0)
+			{
+				_certificate->writeEqualityClosure();
+			}
+			else if (_certificate != nullptr)
+			{
+				unsigned firstId = getCertificateId(closingFirst);
+				_certificate->writeClosure(firstId, closingSecond.get() != 0 ? getCertificateId(closingSecond) : 0);
+			}
 			return true;
 		}
 		else if (checkIfExistsNonGammaRule(d_formulae, rule, tType))
 		{
+			_statistics.ruleApplications++;
 			if (tType == BaseSignedFormula::TT_ALPHA || tType == BaseSignedFormula::TT_BETA)
 			{
 				switch (rule->getFormula()->getType())
@@ -195,21 +562,43 @@ bool Tableaux::prove(deque<SignedFormula>&& d_formulae, deque<FunctionSymbol>&&
 			bool isOpenedBranch = checkIfShouldBranchBeOpenForGammaRule(d_formulae, d_constants);
 			if (isOpenedBranch)
 			{
-				// mark the branch as open 
-				cout << string(tabs, '\t') << "O" << endl;
+				openBranch(move(d_formulae), move(d_constants), tabs);
 				return false;
 			}
 			else 
 			{
+				_statistics.ruleApplications++;
 				return prove(move(d_formulae), move(d_constants), tabs);
 			}
 		}
 	}
 	else
 	{
-		d_formulae.push_back(_root);
-		deque<FunctionSymbol> d_firstConstants;
-		_root->getFormula()->getConstants(d_firstConstants);
+		// The premises come first, as the alpha rule for F (A => C) would put them
+		for (const SignedFormula & premise : _prefix->formulae)
+		{
+			if (_certificate != nullptr)
+			{
+				_certificate->writeInput(getCertificateId(premise), premise->getSign(), premise->getFormula());
+			}
+			addToBranch(d_formulae, premise);
+		}
+		deque<FunctionSymbol> d_firstConstants = _prefix->constants;
+		if (_root.get() != 0)
+		{
+			if (_certificate != nullptr)
+			{
+				_certificate->writeInput(getCertificateId(_root), _root->getSign(), _root->getFormula());
+			}
+			addToBranch(d_formulae, _root);
+			_root->getFormula()->getConstants(d_firstConstants);
+		}
+		// Without premises and conjecture there is nothing to close the branch
+		if (d_formulae.empty())
+		{
+			openBranch(move(d_formulae), move(d_firstConstants), tabs);
+			return false;
+		}
 		if (d_firstConstants.size() == 0)
 		{
 			FunctionSymbol initConstant = getUniqueConstantSymbol();
@@ -219,11 +608,26 @@ bool Tableaux::prove(deque<SignedFormula>&& d_formulae, deque<FunctionSymbol>&&
 	}
 }
 
-bool Tableaux::checkIfExistsComplementaryPairOfLiterals(deque<SignedFormula>& d_formulae) const
+bool Tableaux::checkIfExistsComplementaryPairOfLiterals(deque<SignedFormula>& d_formulae, SignedFormula & first, SignedFormula & second) const
 {
+	// The literals of the branch may close it only modulo equality
+	if (_hasEquality && _congruence.isInconsistent())
+	{
+		return true;
+	}
+
 	deque<SignedFormula>::const_iterator iter_outer = d_formulae.cbegin();
 	for (; iter_outer != d_formulae.cend(); ++iter_outer)
 	{
+		// T false and F true close the branch on their own
+		BaseFormula::Type fType = (*iter_outer)->getFormula()->getType();
+		if (((*iter_outer)->getSign() && fType == BaseFormula::T_FALSE) ||
+			(!(*iter_outer)->getSign() && fType == BaseFormula::T_TRUE))
+		{
+			first = *iter_outer;
+			return true;
+		}
+
 		// If the formula is not an atom, we can skip the check
 		if ((*iter_outer)->getFormula()->getType() != BaseFormula::T_ATOM)
 		{
@@ -237,6 +641,8 @@ bool Tableaux::checkIfExistsComplementaryPairOfLiterals(deque<SignedFormula>& d_
 			if ((*iter_outer)->getSign() != (*iter_inner)->getSign() &&
 				(*iter_outer)->getFormula()->equalTo((*iter_inner)->getFormula()))
 			{
+				first = *iter_outer;
+				second = *iter_inner;
 				return true;
 			}
 		}
@@ -247,6 +653,25 @@ bool Tableaux::checkIfExistsComplementaryPairOfLiterals(deque<SignedFormula>& d_
 
 bool Tableaux::checkIfExistsNonGammaRule(deque<SignedFormula>& d_formulae, SignedFormula & rule, BaseSignedFormula::TableauxType & ruleType) const
 {
+	if (_options.betaSelection == TableauxOptions::BS_LOOKAHEAD)
+	{
+		// Rules which do not split the branch always go first
+		deque<SignedFormula>::const_iterator iter = d_formulae.cbegin();
+		for (; iter != d_formulae.cend(); ++iter)
+		{
+			BaseSignedFormula::TableauxType tType = (*iter)->getType();
+			if (tType == BaseSignedFormula::TT_ALPHA || tType == BaseSignedFormula::TT_DELTA)
+			{
+				rule = *iter;
+				ruleType = tType;
+				return true;
+			}
+		}
+
+		ruleType = BaseSignedFormula::TT_BETA;
+		return selectBetaRuleByLookahead(d_formulae, rule);
+	}
+
 	deque<SignedFormula>::const_iterator iter = d_formulae.cbegin();
 	for (; iter != d_formulae.cend(); ++iter)
 	{
@@ -262,9 +687,84 @@ bool Tableaux::checkIfExistsNonGammaRule(deque<SignedFormula>& d_formulae, Signe
 	return false;
 }
 
+bool Tableaux::selectBetaRuleByLookahead(deque<SignedFormula>& d_formulae, SignedFormula & rule) const
+{
+	bool found = false;
+	unsigned bestOpenChildren = 0, bestSize = 0;
+
+	deque<SignedFormula>::const_iterator iter = d_formulae.cbegin();
+	for (; iter != d_formulae.cend(); ++iter)
+	{
+		if ((*iter)->getType() != BaseSignedFormula::TT_BETA)
+		{
+			continue;
+		}
+
+		// Trying the children of a long branch takes a while, so a cancelled proof stops here
+		if (isOutOfResources())
+		{
+			return found;
+		}
+
+		// Prefer the split with the fewest children left open, and then the smallest formula
+		unsigned openChildren = countOpenBetaChildren(d_formulae, *iter);
+		unsigned size = getFormulaSize((*iter)->getFormula());
+		if (!found || openChildren < bestOpenChildren ||
+			(openChildren == bestOpenChildren && size < bestSize))
+		{
+			found = true;
+			rule = *iter;
+			bestOpenChildren = openChildren;
+			bestSize = size;
+
+			// A split with both children closing cannot be beaten
+			if (openChildren == 0)
+			{
+				break;
+			}
+		}
+	}
+
+	return found;
+}
+
+unsigned Tableaux::countOpenBetaChildren(deque<SignedFormula>& d_formulae, const SignedFormula & f) const
+{
+	SignedFormula components[2];
+	f->getBetaComponents(components[0], components[1]);
+
+	unsigned openChildren = 0;
+	for (const SignedFormula & component : components)
+	{
+		Formula cf = component->getFormula();
+
+		// T false and F true close the child on their own
+		if ((component->getSign() && cf->getType() == BaseFormula::T_FALSE) ||
+			(!component->getSign() && cf->getType() == BaseFormula::T_TRUE))
+		{
+			continue;
+		}
+
+		// A literal closes the child if its complement is already on the branch
+		if (cf->getType() == BaseFormula::T_ATOM)
+		{
+			SignedFormula complement = make_shared<BaseSignedFormula>(cf, !component->getSign());
+			if (find(d_formulae.cbegin(), d_formulae.cend(), complement) != d_formulae.cend())
+			{
+				continue;
+			}
+		}
+
+		++openChildren;
+	}
+
+	return openChildren;
+}
+
 bool Tableaux::checkIfShouldBranchBeOpenForGammaRule(deque<SignedFormula>& d_formulae, deque<FunctionSymbol> & d_constants) const
 {
 	deque<SignedFormula> d_gammaFormulae, d_nextFormulaeNode;
+	BranchLevel branchLevel = getBranchLevel();
 	deque<SignedFormula>::const_iterator iterFormulae = d_formulae.cbegin();
 	
 	for (; iterFormulae != d_formulae.cend(); ++iterFormulae)
@@ -283,6 +783,14 @@ bool Tableaux::checkIfShouldBranchBeOpenForGammaRule(deque<SignedFormula>& d_for
 	iterFormulae = d_gammaFormulae.cbegin();
 	for (; iterFormulae != d_gammaFormulae.cend(); ++iterFormulae)
 	{
+		// Instantiating many gamma formulae takes a while; out of resources the branch is left
+		// as it is, and the next call of prove unwinds the tableaux
+		if (isOutOfResources())
+		{
+			backtrackBranch(branchLevel);
+			return false;
+		}
+
 		deque<FunctionSymbol>::const_iterator iterConstants = d_constants.cbegin();
 		for (; iterConstants != d_constants.cend(); ++iterConstants)
 		{
@@ -293,12 +801,13 @@ bool Tableaux::checkIfShouldBranchBeOpenForGammaRule(deque<SignedFormula>& d_for
 			
 			Formula instFormula = (*iterFormulae)->getFormula()->instantiate(v, make_shared<FunctionTerm>(*iterConstants));
 			SignedFormula instSignedFormula = make_shared<BaseSignedFormula>(instFormula, (*iterFormulae)->getSign());
-			
-			deque<SignedFormula>::const_iterator iterFindFormulaeInner = find(d_nextFormulaeNode.cbegin(), d_nextFormulaeNode.cend(), instSignedFormula);
-			if (iterFindFormulaeInner == d_nextFormulaeNode.cend())
+			if (_certificate != nullptr)
 			{
-				d_nextFormulaeNode.push_back(instSignedFormula);
+				unsigned parentId = getCertificateId(*iterFormulae);
+				_certificate->writeGamma(parentId, getCertificateId(instSignedFormula), *iterConstants);
 			}
+			
+			addToBranch(d_nextFormulaeNode, instSignedFormula);
 		}
 	}
 	
@@ -311,6 +820,8 @@ bool Tableaux::checkIfShouldBranchBeOpenForGammaRule(deque<SignedFormula>& d_for
 
 	if (checkIfAlreadyExistsSuchNode(d_nextFormulaeNode))
 	{
+		// The instances are not added to the branch after all
+		backtrackBranch(branchLevel);
 		return true;
 	}
 
@@ -321,6 +832,152 @@ bool Tableaux::checkIfShouldBranchBeOpenForGammaRule(deque<SignedFormula>& d_for
 	return false;
 }
 
+Tableaux::BranchLevel Tableaux::getBranchLevel() const
+{
+	BranchLevel level;
+	level.congruence = _congruence.getLevel();
+	level.literals = _branchLiteralTrail.size();
+	return level;
+}
+
+void Tableaux::backtrackBranch(const BranchLevel & level) const
+{
+	_congruence.backtrack(level.congruence);
+	while (_branchLiteralTrail.size() > level.literals)
+	{
+		_branchLiterals[_branchLiteralTrail.back()].pop_back();
+		_branchLiteralTrail.pop_back();
+	}
+}
+
+void Tableaux::addToBranch(deque<SignedFormula>& d_formulae, const SignedFormula & f) const
+{
+	SignedFormula sf = f;
+
+	if (_options.simplifyBranches)
+	{
+		// Simplify the new formula against the literals which are already on the branch
+		sf = simplifyByBranchLiterals(sf);
+
+		// T true and F false carry no information, so they are not added at all
+		BaseFormula::Type fType = sf->getFormula()->getType();
+		if ((sf->getSign() && fType == BaseFormula::T_TRUE) ||
+			(!sf->getSign() && fType == BaseFormula::T_FALSE))
+		{
+			return;
+		}
+	}
+
+	deque<SignedFormula>::const_iterator iter = find(d_formulae.cbegin(), d_formulae.cend(), sf);
+	if (iter != d_formulae.cend())
+	{
+		return;
+	}
+	d_formulae.push_back(sf);
+
+	if (_hasEquality && sf->getFormula()->getType() == BaseFormula::T_ATOM)
+	{
+		_congruence.assertLiteral(sf->getFormula(), sf->getSign());
+	}
+
+	// A new literal simplifies the formulae which are already on the branch
+	if (_options.simplifyBranches && sf->getFormula()->getType() == BaseFormula::T_ATOM)
+	{
+		const PredicateSymbol & symbol = ((Atom *)sf->getFormula().get())->getSymbol();
+		_branchLiterals[symbol].push_back(sf);
+		_branchLiteralTrail.push_back(symbol);
+		simplifyBranchByLiteral(d_formulae, sf);
+	}
+}
+
+void Tableaux::simplifyBranchByLiteral(deque<SignedFormula>& d_formulae, const SignedFormula & literal) const
+{
+	Formula atom = literal->getFormula();
+	Formula constant = literal->getSign() ? Formula(make_shared<True>()) : Formula(make_shared<False>());
+	deque<SignedFormula> d_simplified;
+
+	// Collect and remove the formulae in which the atom occurs
+	deque<SignedFormula>::iterator iter = d_formulae.begin();
+	while (iter != d_formulae.end())
+	{
+		if ((*iter)->getType() == BaseSignedFormula::TT_ATOM)
+		{
+			++iter;
+			continue;
+		}
+
+		Formula substituted = (*iter)->getFormula()->substituteAtom(atom, constant);
+		if (substituted == (*iter)->getFormula())
+		{
+			++iter;
+			continue;
+		}
+
+		d_simplified.push_back(make_shared<BaseSignedFormula>(substituted->absorbConstants(), (*iter)->getSign()));
+		if (_certificate != nullptr)
+		{
+			unsigned parentId = getCertificateId(*iter);
+			unsigned childId = getCertificateId(d_simplified.back());
+			_certificate->writeSimplification(parentId, childId, { getCertificateId(literal) });
+		}
+		iter = d_formulae.erase(iter);
+	}
+
+	// Add them back simplified; the literals they turn into propagate further
+	for (iter = d_simplified.begin(); iter != d_simplified.end(); ++iter)
+	{
+		addToBranch(d_formulae, *iter);
+	}
+}
+
+SignedFormula Tableaux::simplifyByBranchLiterals(const SignedFormula & f) const
+{
+	if (f->getType() == BaseSignedFormula::TT_ATOM)
+	{
+		return f;
+	}
+
+	// Only the literals of the predicates in the formula can change it
+	set<PredicateSymbol> symbols;
+	getPredicateSymbols(f->getFormula(), symbols);
+
+	Formula simplified = f->getFormula();
+	// The literals which changed the formula, for the certificate
+	vector<unsigned> literals;
+	for (const PredicateSymbol & symbol : symbols)
+	{
+		unordered_map<PredicateSymbol, vector<SignedFormula>>::const_iterator iter = _branchLiterals.find(symbol);
+		if (iter == _branchLiterals.end())
+		{
+			continue;
+		}
+
+		for (const SignedFormula & literal : iter->second)
+		{
+			Formula constant = literal->getSign() ? Formula(make_shared<True>()) : Formula(make_shared<False>());
+			Formula substituted = simplified->substituteAtom(literal->getFormula(), constant);
+			if (_certificate != nullptr && substituted != simplified)
+			{
+				literals.push_back(getCertificateId(literal));
+			}
+			simplified = substituted;
+		}
+	}
+
+	if (simplified == f->getFormula())
+	{
+		return f;
+	}
+
+	SignedFormula sf = make_shared<BaseSignedFormula>(simplified->absorbConstants(), f->getSign());
+	if (_certificate != nullptr)
+	{
+		unsigned parentId = getCertificateId(f);
+		_certificate->writeSimplification(parentId, getCertificateId(sf), literals);
+	}
+	return sf;
+}
+
 bool Tableaux::atomRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol> && d_constants, const SignedFormula & f, int tabs) const
 {
 	deque<SignedFormula>::const_iterator iter = find(d_formulae.cbegin(), d_formulae.cend(), f);
@@ -336,17 +993,18 @@ bool Tableaux::notRules(deque<SignedFormula>&& d_formulae, deque<FunctionSymbol>
 {
 	Not * pRule = (Not *)f->getFormula().get();
 	SignedFormula sfOp = make_shared<BaseSignedFormula>(pRule->getOperand(), !f->getSign());
+	if (_certificate != nullptr)
+	{
+		unsigned parentId = getCertificateId(f);
+		_certificate->writeAlpha(parentId, getCertificateId(sfOp), 0);
+	}
 	
 	deque<SignedFormula>::const_iterator iter = find(d_formulae.cbegin(), d_formulae.cend(), f);
 	if (iter != d_formulae.cend())
 	{
 		d_formulae.erase(iter);
 	}
-	iter = find(d_formulae.cbegin(), d_formulae.cend(), sfOp);
-	if (iter == d_formulae.cend())
-	{
-		d_formulae.push_back(sfOp);
-	}
+	addToBranch(d_formulae, sfOp);
 
 	return prove(move(d_formulae), move(d_constants), tabs);
 }
@@ -365,16 +1023,14 @@ bool Tableaux::andRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol
 		SignedFormula sfOp1 = make_shared<BaseSignedFormula>(((And*)f->getFormula().get())->getOperand1(), true);
 		SignedFormula sfOp2 = make_shared<BaseSignedFormula>(((And*)f->getFormula().get())->getOperand2(), true);
 
-		iter = find(d_formulae.cbegin(), d_formulae.cend(), sfOp1);
-		if (iter == d_formulae.cend())
-		{
-			d_formulae.push_back(sfOp1);
-		}
-		iter = find(d_formulae.cbegin(), d_formulae.cend(), sfOp2);
-		if (iter == d_formulae.cend())
+		if (_certificate != nullptr)
 		{
-			d_formulae.push_back(sfOp2);
+			unsigned parentId = getCertificateId(f);
+			unsigned firstId = getCertificateId(sfOp1);
+			_certificate->writeAlpha(parentId, firstId, getCertificateId(sfOp2));
 		}
+		addToBranch(d_formulae, sfOp1);
+		addToBranch(d_formulae, sfOp2);
 
 		return prove(move(d_formulae), move(d_constants), tabs);
 	}
@@ -383,6 +1039,16 @@ bool Tableaux::andRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol
 	{
 		bool res1, res2;
 		std::deque<SignedFormula> tmp(d_formulae);
+		BranchLevel branchLevel = getBranchLevel();
+
+		SignedFormula sfOp1 = make_shared<BaseSignedFormula>(((And*)f->getFormula().get())->getOperand1(), false);
+		SignedFormula sfOp2 = make_shared<BaseSignedFormula>(((And*)f->getFormula().get())->getOperand2(), false);
+		if (_certificate != nullptr)
+		{
+			unsigned parentId = getCertificateId(f);
+			unsigned firstId = getCertificateId(sfOp1);
+			_certificate->writeBeta(parentId, firstId, getCertificateId(sfOp2));
+		}
 
 		// first, check what happens if X is false
 		deque<SignedFormula>::const_iterator iter = find(d_formulae.cbegin(), d_formulae.cend(), f);
@@ -390,10 +1056,20 @@ bool Tableaux::andRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol
 		{
 			d_formulae.erase(iter);
 		}
-		d_formulae.push_back(make_shared<BaseSignedFormula>(((And*)f->getFormula().get())->getOperand1(), false));
+		addToBranch(d_formulae, sfOp1);
 		vector<deque<SignedFormula>> tmp_nodes(_nodes);
 		res1 = prove(move(d_formulae), move(d_constants), tabs + 1);
-		cout << string(tabs + 1, '\t') << (res1 ? "X" : "O") << endl;
+		if (_options.trace)
+		{
+			*_trace << string(tabs + 1, '\t') << (res1 ? "X" : "O") << endl;
+		}
+		backtrackBranch(branchLevel);
+
+		// Out of resources the second branch is not built, and the copies are freed on the way out
+		if (_limit != TL_NONE)
+		{
+			return true;
+		}
 
 		d_formulae = tmp;
 
@@ -406,10 +1082,14 @@ bool Tableaux::andRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol
 			{
 				d_formulae.erase(iter);
 			}
-			d_formulae.push_back(make_shared<BaseSignedFormula>(((And*)f->getFormula().get())->getOperand2(), false));
+			addToBranch(d_formulae, sfOp2);
 			_nodes = tmp_nodes;
 			res2 = prove(move(d_formulae), move(d_constants), tabs + 1);
-			cout << string(tabs + 1, '\t') << (res2 ? "X" : "O") << endl;
+			if (_options.trace)
+			{
+				*_trace << string(tabs + 1, '\t') << (res2 ? "X" : "O") << endl;
+			}
+			backtrackBranch(branchLevel);
 
 			move(d_formulae) = tmp;
 
@@ -431,6 +1111,16 @@ bool Tableaux::orRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol>
 	{
 		bool res1, res2;
 		std::deque<SignedFormula> tmp(d_formulae);
+		BranchLevel branchLevel = getBranchLevel();
+
+		SignedFormula sfOp1 = make_shared<BaseSignedFormula>(((Or*)f->getFormula().get())->getOperand1(), true);
+		SignedFormula sfOp2 = make_shared<BaseSignedFormula>(((Or*)f->getFormula().get())->getOperand2(), true);
+		if (_certificate != nullptr)
+		{
+			unsigned parentId = getCertificateId(f);
+			unsigned firstId = getCertificateId(sfOp1);
+			_certificate->writeBeta(parentId, firstId, getCertificateId(sfOp2));
+		}
 
 		// first, check if X is true
 		deque<SignedFormula>::const_iterator iter = find(d_formulae.cbegin(), d_formulae.cend(), f);
@@ -438,10 +1128,20 @@ bool Tableaux::orRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol>
 		{
 			d_formulae.erase(iter);
 		}
-		d_formulae.push_back(make_shared<BaseSignedFormula>(((Or*)f->getFormula().get())->getOperand1(), true));
+		addToBranch(d_formulae, sfOp1);
 		vector<deque<SignedFormula>> tmp_nodes(_nodes);
 		res1 = prove(move(d_formulae), move(d_constants), tabs + 1);
-		cout << string(tabs + 1, '\t') << (res1 ? "X" : "O") << endl;
+		if (_options.trace)
+		{
+			*_trace << string(tabs + 1, '\t') << (res1 ? "X" : "O") << endl;
+		}
+		backtrackBranch(branchLevel);
+
+		// Out of resources the second branch is not built, and the copies are freed on the way out
+		if (_limit != TL_NONE)
+		{
+			return true;
+		}
 
 		d_formulae = tmp;
 
@@ -454,10 +1154,14 @@ bool Tableaux::orRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol>
 			{
 				d_formulae.erase(iter);
 			}
-			d_formulae.push_back(make_shared<BaseSignedFormula>(((Or*)f->getFormula().get())->getOperand2(), true));
+			addToBranch(d_formulae, sfOp2);
 			_nodes = tmp_nodes;
 			res2 = prove(move(d_formulae), move(d_constants), tabs + 1);
-			cout << string(tabs + 1, '\t') << (res2 ? "X" : "O") << endl;
+			if (_options.trace)
+			{
+				*_trace << string(tabs + 1, '\t') << (res2 ? "X" : "O") << endl;
+			}
+			backtrackBranch(branchLevel);
 
 			d_formulae = tmp;
 
@@ -482,16 +1186,14 @@ bool Tableaux::orRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol>
 		SignedFormula sfOp1 = make_shared<BaseSignedFormula>(((Or*)f->getFormula().get())->getOperand1(), false);
 		SignedFormula sfOp2 = make_shared<BaseSignedFormula>(((Or*)f->getFormula().get())->getOperand2(), false);
 
-		iter = find(d_formulae.cbegin(), d_formulae.cend(), sfOp1);
-		if (iter == d_formulae.cend())
-		{
-			d_formulae.push_back(sfOp1);
-		}
-		iter = find(d_formulae.cbegin(), d_formulae.cend(), sfOp2);
-		if (iter == d_formulae.cend())
+		if (_certificate != nullptr)
 		{
-			d_formulae.push_back(sfOp2);
+			unsigned parentId = getCertificateId(f);
+			unsigned firstId = getCertificateId(sfOp1);
+			_certificate->writeAlpha(parentId, firstId, getCertificateId(sfOp2));
 		}
+		addToBranch(d_formulae, sfOp1);
+		addToBranch(d_formulae, sfOp2);
 
 		return prove(move(d_formulae), move(d_constants), tabs);
 	}
@@ -504,6 +1206,16 @@ bool Tableaux::impRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol
 	{
 		bool res1, res2;
 		std::deque<SignedFormula> tmp(d_formulae);
+		BranchLevel branchLevel = getBranchLevel();
+
+		SignedFormula sfOp1 = make_shared<BaseSignedFormula>(((Imp*)f->getFormula().get())->getOperand1(), false);
+		SignedFormula sfOp2 = make_shared<BaseSignedFormula>(((Imp*)f->getFormula().get())->getOperand2(), true);
+		if (_certificate != nullptr)
+		{
+			unsigned parentId = getCertificateId(f);
+			unsigned firstId = getCertificateId(sfOp1);
+			_certificate->writeBeta(parentId, firstId, getCertificateId(sfOp2));
+		}
 
 		// first, check if X is false
 		deque<SignedFormula>::const_iterator iter = find(d_formulae.cbegin(), d_formulae.cend(), f);
@@ -511,10 +1223,20 @@ bool Tableaux::impRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol
 		{
 			d_formulae.erase(iter);
 		}
-		d_formulae.push_back(make_shared<BaseSignedFormula>(((Imp*)f->getFormula().get())->getOperand1(), false));
+		addToBranch(d_formulae, sfOp1);
 		vector<deque<SignedFormula>> tmp_nodes(_nodes);
 		res1 = prove(move(d_formulae), move(d_constants), tabs + 1);
-		cout << string(tabs + 1, '\t') << (res1 ? "X" : "O") << endl;
+		if (_options.trace)
+		{
+			*_trace << string(tabs + 1, '\t') << (res1 ? "X" : "O") << endl;
+		}
+		backtrackBranch(branchLevel);
+
+		// Out of resources the second branch is not built, and the copies are freed on the way out
+		if (_limit != TL_NONE)
+		{
+			return true;
+		}
 
 		d_formulae = tmp;
 
@@ -527,10 +1249,14 @@ bool Tableaux::impRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol
 			{
 				d_formulae.erase(iter);
 			}
-			d_formulae.push_back(make_shared<BaseSignedFormula>(((Imp*)f->getFormula().get())->getOperand2(), true));
+			addToBranch(d_formulae, sfOp2);
 			_nodes = tmp_nodes;
 			res2 = prove(move(d_formulae), move(d_constants), tabs + 1);
-			cout << string(tabs + 1, '\t') << (res2 ? "X" : "O") << endl;
+			if (_options.trace)
+			{
+				*_trace << string(tabs + 1, '\t') << (res2 ? "X" : "O") << endl;
+			}
+			backtrackBranch(branchLevel);
 
 			d_formulae = tmp;
 
@@ -555,16 +1281,14 @@ bool Tableaux::impRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol
 		SignedFormula sfOp1 = make_shared<BaseSignedFormula>(((Imp*)f->getFormula().get())->getOperand1(), true);
 		SignedFormula sfOp2 = make_shared<BaseSignedFormula>(((Imp*)f->getFormula().get())->getOperand2(), false);
 
-		iter = find(d_formulae.cbegin(), d_formulae.cend(), sfOp1);
-		if (iter == d_formulae.cend())
-		{
-			d_formulae.push_back(sfOp1);
-		}
-		iter = find(d_formulae.cbegin(), d_formulae.cend(), sfOp2);
-		if (iter == d_formulae.cend())
+		if (_certificate != nullptr)
 		{
-			d_formulae.push_back(sfOp2);
+			unsigned parentId = getCertificateId(f);
+			unsigned firstId = getCertificateId(sfOp1);
+			_certificate->writeAlpha(parentId, firstId, getCertificateId(sfOp2));
 		}
+		addToBranch(d_formulae, sfOp1);
+		addToBranch(d_formulae, sfOp2);
 
 		return prove(move(d_formulae), move(d_constants), tabs);
 	}
@@ -582,6 +1306,12 @@ bool Tableaux::forallRules(deque<SignedFormula> && d_formulae, deque<FunctionSym
 	FunctionSymbol newConstant = getUniqueConstantSymbol(d_formulae);
 	Forall * pForall = (Forall *)f->getFormula().get();
 	Formula instFormula = f->getFormula()->instantiate(pForall->getVariable(), make_shared<FunctionTerm>(newConstant));
+	SignedFormula instSignedFormula = make_shared<BaseSignedFormula>(instFormula, f->getSign());
+	if (_certificate != nullptr)
+	{
+		unsigned parentId = getCertificateId(f);
+		_certificate->writeDelta(parentId, getCertificateId(instSignedFormula), newConstant);
+	}
 
 	// Remove the formula from the deque and add the instantiated formula
 	deque<SignedFormula>::const_iterator iterSignedFormula = find(d_formulae.cbegin(), d_formulae.cend(), f);
@@ -589,7 +1319,7 @@ bool Tableaux::forallRules(deque<SignedFormula> && d_formulae, deque<FunctionSym
 	{
 		d_formulae.erase(iterSignedFormula);
 	}
-	d_formulae.push_back(make_shared<BaseSignedFormula>(instFormula, f->getSign()));
+	addToBranch(d_formulae, instSignedFormula);
 
 	// Add the new constant to the constants deque
 	d_constants.push_back(newConstant);
@@ -609,6 +1339,12 @@ bool Tableaux::existsRules(deque<SignedFormula> && d_formulae, deque<FunctionSym
 	FunctionSymbol newConstant = getUniqueConstantSymbol(d_formulae);
 	Exists * pExists = (Exists *)f->getFormula().get();
 	Formula instFormula = f->getFormula()->instantiate(pExists->getVariable(), make_shared<FunctionTerm>(newConstant));
+	SignedFormula instSignedFormula = make_shared<BaseSignedFormula>(instFormula, f->getSign());
+	if (_certificate != nullptr)
+	{
+		unsigned parentId = getCertificateId(f);
+		_certificate->writeDelta(parentId, getCertificateId(instSignedFormula), newConstant);
+	}
 
 	// Remove the formula from the deque and add the instantiated formula
 	deque<SignedFormula>::const_iterator iterSignedFormula = find(d_formulae.cbegin(), d_formulae.cend(), f);
@@ -616,7 +1352,7 @@ bool Tableaux::existsRules(deque<SignedFormula> && d_formulae, deque<FunctionSym
 	{
 		d_formulae.erase(iterSignedFormula);
 	}
-	d_formulae.push_back(make_shared<BaseSignedFormula>(instFormula, f->getSign()));
+	addToBranch(d_formulae, instSignedFormula);
 
 	// Add the new constant to the constants deque
 	d_constants.push_back(newConstant);
@@ -624,9 +1360,9 @@ bool Tableaux::existsRules(deque<SignedFormula> && d_formulae, deque<FunctionSym
 	return prove(move(d_formulae), move(d_constants), tabs);
 }
 
-FunctionSymbol Tableaux::getUniqueConstantSymbol(deque<SignedFormula> & d_formulae) const
+FunctionSymbol Tableaux::getUniqueConstantSymbol(const deque<SignedFormula> & d_formulae) const
 {
-	static unsigned i = 0;
+	unsigned & i = _nextConstant;
 	FunctionSymbol uniqueConstant = "uc" + to_string(i);
 
 	deque<SignedFormula>::const_iterator iterFormulae = d_formulae.cbegin();
@@ -648,26 +1384,38 @@ FunctionSymbol Tableaux::getUniqueConstantSymbol(deque<SignedFormula> & d_formul
 	return uniqueConstant;
 }
 
-// END Tableaux
-// ----------------------------------------------------------------------------
-
-ostream & operator<<(ostream & ostr, SignedFormula sf)
+// The search ends at the first open branch, so its formulae are kept without a copy
+void Tableaux::openBranch(deque<SignedFormula> && d_formulae, deque<FunctionSymbol> && d_constants, int tabs) const
 {
-	sf->printSignedFormula(ostr);
-	return ostr;
+	_statistics.openBranches++;
+	if (_options.trace)
+	{
+		*_trace << string(tabs, '\t') << "O" << endl;
+	}
+	if (_certificate != nullptr)
+	{
+		_certificate->writeOpen();
+	}
+	_openBranch = move(d_formulae);
+	_openConstants = move(d_constants);
 }
 
-inline bool operator==(const SignedFormula& lhs, const SignedFormula& rhs)
+// Numbers the formula the first time it is written to the certificate
+unsigned Tableaux::getCertificateId(const SignedFormula & f) const
 {
-	bool ret = lhs->getSign() == rhs->getSign() &&
-		lhs->getFormula()->equalTo(rhs->getFormula());
-	
-	/*cout << endl << "****************** DEBUG ******************" << endl << "Comparing: " << lhs->getFormula() << " == " << rhs->getFormula() << (ret ? "true" : "false") << endl << "****************** DEBUG ******************" << endl << endl;*/
-	
-	return ret;
+	unordered_map<const BaseSignedFormula *, unsigned>::const_iterator iter = _certificateIds.find(f.get());
+	if (iter != _certificateIds.end())
+	{
+		return iter->second;
+	}
+
+	_certificateFormulae.push_back(f);
+	unsigned id = _certificateFormulae.size();
+	_certificateIds[f.get()] = id;
+	return id;
 }
 
-bool checkIfAlreadyExistsSuchNode(deque<SignedFormula>& d_nextFormulaeNode)
+bool Tableaux::checkIfAlreadyExistsSuchNode(deque<SignedFormula> & d_nextFormulaeNode) const
 {
 	vector<deque<SignedFormula>>::const_iterator iterNodes = _nodes.cbegin();
 	for (; iterNodes != _nodes.cend(); ++iterNodes)
@@ -700,6 +1448,86 @@ bool checkIfAlreadyExistsSuchNode(deque<SignedFormula>& d_nextFormulaeNode)
 	return false;
 }
 
+// END Tableaux
+// ----------------------------------------------------------------------------
+
+ostream & operator<<(ostream & ostr, SignedFormula sf)
+{
+	sf->printSignedFormula(ostr);
+	return ostr;
+}
+
+inline bool operator==(const SignedFormula& lhs, const SignedFormula& rhs)
+{
+	bool ret = lhs->getSign() == rhs->getSign() &&
+		lhs->getFormula()->equalTo(rhs->getFormula());
+	
+	/*cout << endl << "****************** DEBUG ******************" << endl << "Comparing: " << lhs->getFormula() << " == " << rhs->getFormula() << (ret ? "true" : "false") << endl << "****************** DEBUG ******************" << endl << endl;*/
+	
+	return ret;
+}
+
+string getLimitName(TableauxLimit limit)
+{
+	switch (limit)
+	{
+		case TL_TIME:
+			return "time";
+		case TL_RULES:
+			return "rules";
+		case TL_MEMORY:
+			return "memory";
+		case TL_CANCELLED:
+			return "cancelled";
+		default:
+			return "";
+	}
+}
+
+Formula prepareForTableaux(const Formula & f)
+{
+	// First, eliminate all equivalents from the formula, and then eliminate all constants from the formula
+	Formula transformed = f->releaseIff()->absorbConstants();
+
+	// If the transformed formula is a logic constant true, then...
+	if (transformed->getType() == BaseFormula::T_TRUE)
+	{
+		// ... transform the formula into its equivalent form without logic constants
+		transformed = ((True*)transformed.get())->transformToDisjunction();
+	}
+	// If the transformed formula is a logic constant false, then...
+	else if (transformed->getType() == BaseFormula::T_FALSE)
+	{
+		// ... transform the formula into its equivalent form without logic constants
+		transformed = ((False*)transformed.get())->transformToConjunction();
+	}
+	// Otherwise, do nothing
+
+	return transformed;
+}
+
+unsigned getFormulaSize(const Formula & f)
+{
+	switch (f->getType())
+	{
+		case BaseFormula::T_NOT:
+			return 1 + getFormulaSize(((Not *)f.get())->getOperand());
+		case BaseFormula::T_AND:
+		case BaseFormula::T_OR:
+		case BaseFormula::T_IMP:
+		case BaseFormula::T_IFF:
+		{
+			BinaryConjective * pBinary = (BinaryConjective *)f.get();
+			return 1 + getFormulaSize(pBinary->getOperand1()) + getFormulaSize(pBinary->getOperand2());
+		}
+		case BaseFormula::T_FORALL:
+		case BaseFormula::T_EXISTS:
+			return 1 + getFormulaSize(((Quantifier *)f.get())->getOperand());
+		default:
+			return 1;
+	}
+}
+
 template<class T>
 ostream & operator<<(ostream & ostr, deque<T> & d_T)
 {
@@ -2,12 +2,20 @@
 #define _TABLEAUX_H
 
 #include <algorithm>
+#include <chrono>
 #include <deque>
 #include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "fol.hpp"
+#include "congruence.h"
+#include "cancellation.h"
+#include "certificate.h"
 
 class BaseSignedFormula;
+class Theory;
 
 typedef shared_ptr<BaseSignedFormula> SignedFormula;
 
@@ -29,22 +37,147 @@ public:
 	bool getSign() const;
 	void printSignedFormula(ostream & ostr) const;
 	TableauxType getType() const;
+	void getBetaComponents(SignedFormula & component1, SignedFormula & component2) const;
+	// The second component is empty for a negation
+	void getAlphaComponents(SignedFormula & component1, SignedFormula & component2) const;
 
 	~BaseSignedFormula()
 	{}
 };
 
+struct TableauxOptions
+{
+	enum BetaSelection {
+		BS_FIRST, BS_LOOKAHEAD
+	};
+
+	// Simplify the formulae on a branch against its literals (Massacci-style)
+	bool simplifyBranches = false;
+	// Which formula is split when there are several beta formulae on a branch
+	BetaSelection betaSelection = BS_FIRST;
+	// Write the tableaux while it is being built
+	bool trace = true;
+	// Where the tableaux is written, the standard output if not set
+	ostream * traceOutput = nullptr;
+	// The result is UNKNOWN if the proof takes more milliseconds than this, 0 means no limit
+	unsigned timeLimit = 0;
+	// Prove a conjecture only from the premises selected for it in this many steps
+	// by a RelevanceFilter, 0 means from all the premises; used by all engines
+	unsigned relevanceDepth = 0;
+	// How much more common than the rarest symbol of a premise a symbol may be to select it
+	double relevanceTolerance = 1.0;
+	// When it is cancelled from another thread, the proof gives up with UNKNOWN as if out of time
+	CancellationToken cancellation;
+	// The result is UNKNOWN after this many rule applications, 0 means no limit
+	unsigned ruleLimit = 0;
+	// The result is UNKNOWN when the process holds more bytes than this in memory, 0 means no limit;
+	// it is the memory of the whole process, so proofs running at once share it
+	size_t memoryLimit = 0;
+	// Look for a finite counter-model with a ModelFinder on another thread while the
+	// tableaux is built, and stop the tableaux if one is found; only with a Theory
+	bool findModels = false;
+	// Where the certificate of the proof is written, see CertificateWriter, or none if not set
+	ostream * certificateOutput = nullptr;
+};
+
+/* Why a tableaux gave up with the result UNKNOWN. */
+enum TableauxLimit
+{
+	TL_NONE,
+	TL_TIME,
+	TL_RULES,
+	TL_MEMORY,
+	TL_CANCELLED
+};
+
+/* The start of a branch which is shared by several tableaux: the formulae
+put on the branch before the conjecture, their constants and whether there
+are equalities among them. */
+struct TableauxPrefix
+{
+	deque<SignedFormula> formulae;
+	deque<FunctionSymbol> constants;
+	bool hasEquality = false;
+};
+
+/* What was done while building the tableaux. */
+struct TableauxStatistics
+{
+	unsigned ruleApplications = 0;
+	unsigned closedBranches = 0;
+	unsigned openBranches = 0;
+	// The most memory of the process seen while checking the memory limit, 0 if it was not checked
+	size_t peakMemory = 0;
+};
+
 class Tableaux
 {
 private:
+	// The state of the branch kept outside of its formulae, see getBranchLevel
+	struct BranchLevel
+	{
+		unsigned congruence;
+		unsigned literals;
+	};
+
+	// The negated conjecture, if there is one
 	SignedFormula _root;
+	// The start of the branch, used only while the tableaux is built by the constructor
+	const TableauxPrefix * _prefix;
+	TableauxOptions _options;
+	ostream * _trace;
+	chrono::steady_clock::time_point _deadline;
+	// The limit that was reached, once the proof gives up
+	mutable TableauxLimit _limit;
+	// The rule applications after which the memory is measured again
+	mutable unsigned _nextMemoryCheck;
+	mutable TableauxStatistics _statistics;
+	// Ground equality reasoning for the current branch, used only if the formula contains equalities
+	mutable CongruenceClosure _congruence;
+	bool _hasEquality;
+	// The literals of the branch by predicate symbol, kept only if the branches are simplified;
+	// the symbols are also on a trail in the order the literals were added, so that they can be undone
+	mutable unordered_map<PredicateSymbol, vector<SignedFormula>> _branchLiterals;
+	mutable vector<PredicateSymbol> _branchLiteralTrail;
+	// Every branch node created by the gamma rules, used to detect loops
+	mutable vector<deque<SignedFormula>> _nodes;
+	// The counter from which new constants for the delta rules are made
+	mutable unsigned _nextConstant;
+	// The formulae and constants of the open branch, from which the counter-model is read
+	mutable deque<SignedFormula> _openBranch;
+	mutable deque<FunctionSymbol> _openConstants;
+	// The finite counter-model found by the model finder, if it was faster than the tableaux
+	string _finiteModel;
+	// The certificate, if it is asked for, and the numbers of the formulae written to it;
+	// the formulae are kept, so that their addresses are not taken by other ones
+	unique_ptr<CertificateWriter> _certificate;
+	mutable unordered_map<const BaseSignedFormula *, unsigned> _certificateIds;
+	mutable vector<SignedFormula> _certificateFormulae;
 	bool _result;
 
+	Tableaux(const TableauxPrefix & prefix, const Formula & conjecture, const TableauxOptions & options, const Theory * premises);
+	void proveWithModelFinder(const Theory & premises, const Formula & conjecture);
+
+	bool isOutOfResources() const;
 	bool prove(deque<SignedFormula> && d_formulae = deque<SignedFormula>(), deque<FunctionSymbol> && d_constants = deque<FunctionSymbol>(), int tabs = 0) const;
 	
-	bool checkIfExistsComplementaryPairOfLiterals(deque<SignedFormula> & d_formulae) const;
+	// Sets the literals which close the branch, or none if its equalities do
+	bool checkIfExistsComplementaryPairOfLiterals(deque<SignedFormula> & d_formulae, SignedFormula & first, SignedFormula & second) const;
 	bool checkIfExistsNonGammaRule(deque<SignedFormula> & d_formulae, SignedFormula & rule, BaseSignedFormula::TableauxType & ruleType) const;
 	bool checkIfShouldBranchBeOpenForGammaRule(deque<SignedFormula> & d_formulae, deque<FunctionSymbol> & d_constants) const;
+	bool checkIfAlreadyExistsSuchNode(deque<SignedFormula> & d_nextFormulaeNode) const;
+	void openBranch(deque<SignedFormula> && d_formulae, deque<FunctionSymbol> && d_constants, int tabs) const;
+	unsigned getCertificateId(const SignedFormula & f) const;
+
+	bool selectBetaRuleByLookahead(deque<SignedFormula> & d_formulae, SignedFormula & rule) const;
+	unsigned countOpenBetaChildren(deque<SignedFormula> & d_formulae, const SignedFormula & f) const;
+
+	// Everything added to the branch after getBranchLevel() returned the level is undone by backtrackBranch
+	BranchLevel getBranchLevel() const;
+	void backtrackBranch(const BranchLevel & level) const;
+	void addToBranch(deque<SignedFormula> & d_formulae, const SignedFormula & f) const;
+	void simplifyBranchByLiteral(deque<SignedFormula> & d_formulae, const SignedFormula & literal) const;
+	SignedFormula simplifyByBranchLiterals(const SignedFormula & f) const;
 
 	bool atomRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol> && d_constants, const SignedFormula & f, int tabs) const;
 	bool notRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol> && d_constants, const SignedFormula & f, int tabs) const;
@@ -53,11 +186,35 @@ private:
 	bool impRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol> && d_constants, const SignedFormula & f, int tabs) const;
 	bool forallRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol> && d_constants, const SignedFormula & f, int tabs) const;
 	bool existsRules(deque<SignedFormula> && d_formulae, deque<FunctionSymbol> && d_constants, const SignedFormula & f, int tabs) const;
-	FunctionSymbol getUniqueConstantSymbol(deque<SignedFormula> & d_formulae = deque<SignedFormula>()) const;
+	FunctionSymbol getUniqueConstantSymbol(const deque<SignedFormula> & d_formulae = deque<SignedFormula>()) const;
 public:
-	Tableaux(const Formula & root);
-
+	Tableaux(const Formula & root, const TableauxOptions & options = TableauxOptions());
+	/* Proves that the conjecture follows from the premises. The premises are
+	taken as the theory prepared them. Without a conjecture it is proved that
+	the premises are unsatisfiable. */
+	Tableaux(const Theory & premises, const Formula & conjecture, const TableauxOptions & options = TableauxOptions());
+	/* Proves the conjecture on a branch that starts with the formulae of the
+	prefix, on which rules may already have been applied. */
+	Tableaux(const TableauxPrefix & prefix, const Formula & conjecture, const TableauxOptions & options = TableauxOptions());
+
+	// TAUTOLOGY, NOT A TAUTOLOGY, or UNKNOWN if a limit was reached
 	string getResult() const;
+	TableauxStatistics getStatistics() const;
+	TableauxLimit getLimit() const;
+	/* Gives the Herbrand interpretation of the open branch if the result is
+	NOT A TAUTOLOGY, or an empty string, as
+		{a, c} b = a, f(a) = a, p(a), r(a,f(c)), ~q(c)
+	The domain is the terms built from the constants of the branch, where the
+	terms made congruent by the equalities of the branch are one element. The
+	constants in braces stand for their classes, and every other term of the
+	branch which is in a class is written as equal to the term that stands for
+	it. An atom is true if it is congruent to an atom true on the branch, and
+	false otherwise; the atoms of the branch are written with the terms that
+	stand for their arguments, and the false ones with '~'. Different elements
+	are different, so the disequalities are not written. If the model finder
+	decided the result, it is the finite model as ModelFinder::getModel gives
+	it. */
+	string getCounterModel() const;
 
 	~Tableaux()
 	{}
@@ -70,6 +227,15 @@ inline bool operator==(const SignedFormula& lhs, const SignedFormula& rhs);
 template<class T>
 ostream & operator << (ostream & ostr, deque<T> & d_T);
 
-bool checkIfAlreadyExistsSuchNode(deque<SignedFormula> & d_nextFormulaeNode);
+unsigned getFormulaSize(const Formula & f);
+
+/* Releases the equivalences and absorbs the logic constants of the formula,
+and replaces a remaining true or false by a formula without constants,
+so that it can be put on a branch. */
+Formula prepareForTableaux(const Formula & f);
+
+/* Gives the name of the limit, as "time", "rules", "memory" or "cancelled",
+or an empty string for TL_NONE. */
+string getLimitName(TableauxLimit limit);
 
 #endif // _TABLEAUX_H
\ No newline at end of file
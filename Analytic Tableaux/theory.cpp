@@ -0,0 +1,116 @@
+#include "stdafx.h"
+#include "theory.h"
+#include "congruence.h"
+
+#include <unordered_set>
+
+// ----------------------------------------------------------------------------
+// Theory
+
+Theory::Theory(const vector<Formula> & premises, bool prepared)
+	:_formulas(premises)
+{
+	// The constants are gathered for each premise alone, as looking them up
+	// in the constants of all the premises would take quadratic time
+	unordered_set<FunctionSymbol> seen;
+	for (const Formula & f : _formulas)
+	{
+		Formula ready = prepared ? f : prepareForTableaux(f);
+		_prefix.formulae.push_back(make_shared<BaseSignedFormula>(ready, true));
+		deque<FunctionSymbol> constants;
+		ready->getConstants(constants);
+		for (const FunctionSymbol & c : constants)
+		{
+			if (seen.insert(c).second)
+			{
+				_prefix.constants.push_back(c);
+			}
+		}
+		_prefix.hasEquality = _prefix.hasEquality || containsEquality(ready);
+	}
+}
+
+const vector<Formula> & Theory::getFormulas() const
+{
+	return _formulas;
+}
+
+const TableauxPrefix & Theory::getPrefix() const
+{
+	return _prefix;
+}
+
+const deque<SignedFormula> & Theory::getPremises() const
+{
+	return _prefix.formulae;
+}
+
+const deque<FunctionSymbol> & Theory::getConstants() const
+{
+	return _prefix.constants;
+}
+
+bool Theory::hasEquality() const
+{
+	return _prefix.hasEquality;
+}
+
+void Theory::clausify() const
+{
+	for (const Formula & f : _formulas)
+	{
+		vector<Clause> clauses = _clausifier.clausify(f);
+		_clauses.insert(_clauses.end(), clauses.begin(), clauses.end());
+	}
+}
+
+const vector<Clause> & Theory::getClauses() const
+{
+	call_once(_clausified, &Theory::clausify, this);
+	return _clauses;
+}
+
+Clausifier Theory::getClausifier() const
+{
+	call_once(_clausified, &Theory::clausify, this);
+	return _clausifier;
+}
+
+void Theory::index() const
+{
+	// The filter works on the prepared premises, so that the theory it gives need not prepare them again
+	vector<Formula> premises;
+	for (const SignedFormula & premise : _prefix.formulae)
+	{
+		premises.push_back(premise->getFormula());
+	}
+	_filter.reset(new RelevanceFilter(premises));
+}
+
+unique_ptr<Theory> Theory::selectRelevant(const Formula & conjecture, unsigned depth, double tolerance) const
+{
+	call_once(_indexed, &Theory::index, this);
+	vector<Formula> premises = _filter->select(conjecture, depth, tolerance);
+	if (premises.size() == _prefix.formulae.size())
+	{
+		return nullptr;
+	}
+	return unique_ptr<Theory>(new Theory(premises, true));
+}
+
+void Theory::measure() const
+{
+	for (const Formula & f : _formulas)
+	{
+		_features.add(f, true);
+	}
+}
+
+const FormulaFeatures & Theory::getFeatures() const
+{
+	call_once(_measured, &Theory::measure, this);
+	return _features;
+}
+
+// END Theory
+// ----------------------------------------------------------------------------
@@ -0,0 +1,69 @@
+#ifndef _THEORY_H
+#define _THEORY_H
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "fol.hpp"
+#include "tableaux.h"
+#include "clause.h"
+#include "relevance.h"
+#include "formulafeatures.h"
+
+/* A set of premises prepared once, so that many conjectures can be proved
+against it without preparing the premises again for each of them. The
+premises are made ready for the tableaux at once, and their constants are
+collected; their clauses for Inst-Gen and resolution are only made the first
+time they are asked for. The provers do not change a theory, so it can be
+shared by proofs running on several threads. */
+class Theory
+{
+private:
+	vector<Formula> _formulas;
+	TableauxPrefix _prefix;
+
+	mutable once_flag _clausified;
+	mutable Clausifier _clausifier;
+	mutable vector<Clause> _clauses;
+
+	mutable once_flag _indexed;
+	mutable unique_ptr<RelevanceFilter> _filter;
+
+	mutable once_flag _measured;
+	mutable FormulaFeatures _features;
+
+	void clausify() const;
+	void index() const;
+	void measure() const;
+public:
+	/* With prepared set, the premises are taken as already made ready for the
+	tableaux, like the formulas of a snapshot, and are used as they are. */
+	Theory(const vector<Formula> & premises = vector<Formula>(), bool prepared = false);
+
+	const vector<Formula> & getFormulas() const;
+	// The premises with their constants, to start the branch of the tableaux
+	const TableauxPrefix & getPrefix() const;
+	// The premises as the signed formulas T A, prepared as the tableaux does it
+	const deque<SignedFormula> & getPremises() const;
+	// The constants of all the premises
+	const deque<FunctionSymbol> & getConstants() const;
+	bool hasEquality() const;
+
+	// The clauses of the premises
+	const vector<Clause> & getClauses() const;
+	// The clausifier that made the clauses, from which the conjecture is clausified,
+	// so that its Skolem symbols are new and its free variables are those of the premises
+	Clausifier getClausifier() const;
+
+	/* Gives the theory of the premises relevant to the conjecture, selected
+	by a RelevanceFilter in at most depth steps, or null if no premise is
+	left out. The index of the symbols is built the first time. */
+	unique_ptr<Theory> selectRelevant(const Formula & conjecture, unsigned depth, double tolerance) const;
+
+	// The features of the premises, signed T, gathered the first time they are asked for
+	const FormulaFeatures & getFeatures() const;
+};
+
+#endif // _THEORY_H
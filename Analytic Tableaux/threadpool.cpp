@@ -0,0 +1,55 @@
+#include "stdafx.h"
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(unsigned threads)
+	:_stopping(false)
+{
+	for (unsigned i = 0; i < threads; i++)
+	{
+		_workers.push_back(thread(&ThreadPool::work, this));
+	}
+}
+
+void ThreadPool::work()
+{
+	while (true)
+	{
+		function<void()> task;
+		{
+			unique_lock<mutex> lock(_mutex);
+			_condition.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+
+			// The remaining tasks are still run when the pool is stopping
+			if (_tasks.empty())
+			{
+				return;
+			}
+			task = move(_tasks.front());
+			_tasks.pop();
+		}
+		task();
+	}
+}
+
+void ThreadPool::submit(const function<void()> & task)
+{
+	{
+		lock_guard<mutex> lock(_mutex);
+		_tasks.push(task);
+	}
+	_condition.notify_one();
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_condition.notify_all();
+
+	for (thread & worker : _workers)
+	{
+		worker.join();
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef _THREADPOOL_H
+#define _THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/* A fixed number of worker threads which run the submitted tasks in the
+order of submission. The destructor waits for all submitted tasks to finish. */
+class ThreadPool
+{
+private:
+	vector<thread> _workers;
+	queue<function<void()>> _tasks;
+	mutex _mutex;
+	condition_variable _condition;
+	bool _stopping;
+
+	void work();
+public:
+	ThreadPool(unsigned threads);
+
+	void submit(const function<void()> & task);
+
+	~ThreadPool();
+};
+
+#endif // _THREADPOOL_H
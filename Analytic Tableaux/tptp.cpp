@@ -0,0 +1,856 @@
+#include "stdafx.h"
+#include "tptp.h"
+#include "mappedfile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+static bool isNameCharacter(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+// ----------------------------------------------------------------------------
+// TptpParser
+
+TptpParser::TptpParser(const char * buffer, size_t length)
+	:_buffer(buffer), _length(length), _position(0)
+{
+	nextToken();
+}
+
+bool TptpParser::skipComment()
+{
+	if (_buffer[_position] == '%')
+	{
+		while (_position < _length && _buffer[_position] != '\n')
+		{
+			_position++;
+		}
+		return true;
+	}
+
+	if (_buffer[_position] == '/' && _position + 1 < _length && _buffer[_position + 1] == '*')
+	{
+		_position += 2;
+		while (_position < _length && !(_buffer[_position] == '*' && _position + 1 < _length && _buffer[_position + 1] == '/'))
+		{
+			_position++;
+		}
+		_position = min(_position + 2, _length);
+		return true;
+	}
+	return false;
+}
+
+void TptpParser::nextToken()
+{
+	while (_position < _length)
+	{
+		char c = _buffer[_position];
+		if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+		{
+			_position++;
+		}
+		else if (!skipComment())
+		{
+			break;
+		}
+	}
+
+	_token.text = _buffer + _position;
+	_token.length = 1;
+	if (_position == _length)
+	{
+		_token.type = TK_END;
+		_token.length = 0;
+		return;
+	}
+
+	size_t start = _position;
+	char c = _buffer[_position];
+	if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c == '$' && _position + 1 < _length && isNameCharacter(_buffer[_position + 1])))
+	{
+		_position++;
+		while (_position < _length && (isNameCharacter(_buffer[_position]) || _buffer[_position] == '$'))
+		{
+			_position++;
+		}
+		_token.length = _position - start;
+		_token.type = c == '$' ? TK_DOLLAR : c >= 'a' && c <= 'z' ? TK_LOWER : TK_UPPER;
+		return;
+	}
+
+	if (c == '\'' || c == '"')
+	{
+		// A backslash escapes the next character
+		_position++;
+		while (_position < _length && _buffer[_position] != c)
+		{
+			_position += _buffer[_position] == '\\' ? 2 : 1;
+		}
+		if (_position >= _length)
+		{
+			// The quote is not closed
+			_position = start;
+			_token.type = TK_CHARACTER;
+		}
+		else
+		{
+			_position++;
+			_token.length = _position - start;
+			_token.type = c == '\'' ? TK_QUOTED : TK_DISTINCT;
+			return;
+		}
+	}
+
+	if (isDigit(c) || ((c == '+' || c == '-') && _position + 1 < _length && isDigit(_buffer[_position + 1])))
+	{
+		// Integers, rationals and reals are all just constants here
+		_position++;
+		while (_position < _length && (isDigit(_buffer[_position]) || ((_buffer[_position] == '.' || _buffer[_position] == '/')
+			&& _position + 1 < _length && isDigit(_buffer[_position + 1]))))
+		{
+			_position++;
+		}
+		_token.length = _position - start;
+		_token.type = TK_NUMBER;
+		return;
+	}
+
+	// The longest operator is taken
+	size_t left = _length - _position;
+	if (left >= 3 && strncmp(_token.text, "<=>", 3) == 0)
+	{
+		_token.type = TK_IFF;
+		_token.length = 3;
+	}
+	else if (left >= 3 && strncmp(_token.text, "<~>", 3) == 0)
+	{
+		_token.type = TK_XOR;
+		_token.length = 3;
+	}
+	else if (left >= 2 && strncmp(_token.text, "<=", 2) == 0)
+	{
+		_token.type = TK_REVIMP;
+		_token.length = 2;
+	}
+	else if (left >= 2 && strncmp(_token.text, "=>", 2) == 0)
+	{
+		_token.type = TK_IMP;
+		_token.length = 2;
+	}
+	else if (left >= 2 && strncmp(_token.text, "~|", 2) == 0)
+	{
+		_token.type = TK_NOR;
+		_token.length = 2;
+	}
+	else if (left >= 2 && strncmp(_token.text, "~&", 2) == 0)
+	{
+		_token.type = TK_NAND;
+		_token.length = 2;
+	}
+	else if (left >= 2 && strncmp(_token.text, "!=", 2) == 0)
+	{
+		_token.type = TK_NEQ;
+		_token.length = 2;
+	}
+	else
+	{
+		switch (c)
+		{
+			case '&':
+				_token.type = TK_AND;
+				break;
+			case '|':
+				_token.type = TK_OR;
+				break;
+			case '~':
+				_token.type = TK_NOT;
+				break;
+			case '=':
+				_token.type = TK_EQ;
+				break;
+			case '!':
+				_token.type = TK_FORALL;
+				break;
+			case '?':
+				_token.type = TK_EXISTS;
+				break;
+			default:
+				_token.type = TK_CHARACTER;
+				break;
+		}
+	}
+	_position = start + _token.length;
+}
+
+bool TptpParser::isCharacter(char c) const
+{
+	return _token.type == TK_CHARACTER && *_token.text == c;
+}
+
+void TptpParser::fail(const string & expected)
+{
+	if (!_error.empty())
+	{
+		return;
+	}
+
+	size_t offset = _token.text - _buffer;
+	unsigned line = 1;
+	unsigned column = 1;
+	for (size_t i = 0; i < offset; i++)
+	{
+		if (_buffer[i] == '\n')
+		{
+			line++;
+			column = 1;
+		}
+		else
+		{
+			column++;
+		}
+	}
+
+	_error = "syntax error at " + to_string(line) + ":" + to_string(column) + ", expected " + expected;
+}
+
+bool TptpParser::expect(char c)
+{
+	if (!isCharacter(c))
+	{
+		fail(string("'") + c + "'");
+		return false;
+	}
+	nextToken();
+	return true;
+}
+
+string TptpParser::getName() const
+{
+	if (_token.type != TK_QUOTED)
+	{
+		return string(_token.text, _token.length);
+	}
+
+	// 'abc' is the same name as abc, any other quoted name keeps its quotes
+	string inner(_token.text + 1, _token.length - 2);
+	if (!inner.empty() && inner[0] >= 'a' && inner[0] <= 'z' && all_of(inner.begin(), inner.end(), isNameCharacter))
+	{
+		return inner;
+	}
+	return string(_token.text, _token.length);
+}
+
+bool TptpParser::parseNext(Statement & s, string & error)
+{
+	_error.clear();
+	error.clear();
+	_variables.clear();
+	s = Statement();
+
+	if (_token.type == TK_END)
+	{
+		return false;
+	}
+
+	string keyword(_token.text, _token.length);
+	if (_token.type != TK_LOWER || (keyword != "fof" && keyword != "cnf" && keyword != "include"))
+	{
+		fail("fof, cnf or include");
+		error = _error;
+		return false;
+	}
+	nextToken();
+
+	if (keyword == "include")
+	{
+		if (!parseInclude(s))
+		{
+			error = _error;
+			return false;
+		}
+		return true;
+	}
+
+	s.type = ST_FORMULA;
+	if (!expect('(') || !parseName(s.name) || !expect(','))
+	{
+		error = _error;
+		return false;
+	}
+	if (_token.type != TK_LOWER)
+	{
+		fail("a role");
+		error = _error;
+		return false;
+	}
+	s.role = string(_token.text, _token.length);
+	nextToken();
+
+	if (!expect(','))
+	{
+		error = _error;
+		return false;
+	}
+	s.formula = parseBinary(1);
+	if (s.formula.get() == 0 || !parseAnnotations() || !expect(')') || !expect('.'))
+	{
+		s.formula = Formula();
+		error = _error;
+		return false;
+	}
+
+	// The variables of a clause are bound from the outside in, in the order they appear
+	if (keyword == "cnf")
+	{
+		for (auto v = _variables.rbegin(); v != _variables.rend(); ++v)
+		{
+			s.formula = make_shared<Forall>(*v, s.formula);
+		}
+	}
+	return true;
+}
+
+bool TptpParser::parseName(string & name)
+{
+	if (_token.type != TK_LOWER && _token.type != TK_QUOTED && _token.type != TK_NUMBER)
+	{
+		fail("a name");
+		return false;
+	}
+	name = getName();
+	nextToken();
+	return true;
+}
+
+bool TptpParser::parseAnnotations()
+{
+	if (!isCharacter(','))
+	{
+		return true;
+	}
+	nextToken();
+
+	// The source and the useful info are not used, so they are only skipped
+	unsigned depth = 0;
+	while (depth > 0 || !isCharacter(')'))
+	{
+		if (_token.type == TK_END)
+		{
+			fail("')'");
+			return false;
+		}
+		if (isCharacter('(') || isCharacter('['))
+		{
+			depth++;
+		}
+		else if (isCharacter(')') || isCharacter(']'))
+		{
+			depth--;
+		}
+		nextToken();
+	}
+	return true;
+}
+
+bool TptpParser::parseInclude(Statement & s)
+{
+	s.type = ST_INCLUDE;
+	if (!expect('('))
+	{
+		return false;
+	}
+	if (_token.type != TK_QUOTED)
+	{
+		fail("a file name");
+		return false;
+	}
+	s.name = string(_token.text + 1, _token.length - 2);
+	nextToken();
+
+	if (isCharacter(','))
+	{
+		nextToken();
+		if (!expect('['))
+		{
+			return false;
+		}
+		while (!isCharacter(']'))
+		{
+			string name;
+			if (!parseName(name))
+			{
+				return false;
+			}
+			s.selection.insert(name);
+			if (!isCharacter(','))
+			{
+				break;
+			}
+			nextToken();
+		}
+		if (!expect(']'))
+		{
+			return false;
+		}
+	}
+	return expect(')') && expect('.');
+}
+
+int TptpParser::getPrecedence(TokenType type)
+{
+	switch (type)
+	{
+		case TK_IFF:
+		case TK_XOR:
+		case TK_IMP:
+		case TK_REVIMP:
+		case TK_NOR:
+		case TK_NAND:
+			return 1;
+		case TK_OR:
+			return 2;
+		case TK_AND:
+			return 3;
+		default:
+			return 0;
+	}
+}
+
+Formula TptpParser::parseBinary(int minPrecedence)
+{
+	Formula left = parseUnary();
+	if (left.get() == 0)
+	{
+		return left;
+	}
+
+	while (true)
+	{
+		int precedence = getPrecedence(_token.type);
+		if (precedence == 0 || precedence < minPrecedence)
+		{
+			return left;
+		}
+
+		TokenType op = _token.type;
+		nextToken();
+
+		// TPTP wants the non-associative connectives in parentheses, but they are grouped to the left
+		Formula right = parseBinary(precedence + 1);
+		if (right.get() == 0)
+		{
+			return right;
+		}
+
+		switch (op)
+		{
+			case TK_IFF:
+				left = make_shared<Iff>(left, right);
+				break;
+			case TK_XOR:
+				left = make_shared<Not>(make_shared<Iff>(left, right));
+				break;
+			case TK_IMP:
+				left = make_shared<Imp>(left, right);
+				break;
+			case TK_REVIMP:
+				left = make_shared<Imp>(right, left);
+				break;
+			case TK_NOR:
+				left = make_shared<Not>(make_shared<Or>(left, right));
+				break;
+			case TK_NAND:
+				left = make_shared<Not>(make_shared<And>(left, right));
+				break;
+			case TK_OR:
+				left = make_shared<Or>(left, right);
+				break;
+			default:
+				left = make_shared<And>(left, right);
+				break;
+		}
+	}
+}
+
+Formula TptpParser::parseUnary()
+{
+	switch (_token.type)
+	{
+		case TK_NOT:
+		{
+			nextToken();
+			Formula op = parseUnary();
+			return op.get() == 0 ? op : make_shared<Not>(op);
+		}
+		case TK_FORALL:
+		case TK_EXISTS:
+		{
+			bool forall = _token.type == TK_FORALL;
+			nextToken();
+			if (!expect('['))
+			{
+				return Formula();
+			}
+
+			vector<Variable> variables;
+			while (true)
+			{
+				if (_token.type != TK_UPPER)
+				{
+					fail("a variable");
+					return Formula();
+				}
+				variables.push_back(Variable(_token.text, _token.length));
+				nextToken();
+				if (!isCharacter(','))
+				{
+					break;
+				}
+				nextToken();
+			}
+			if (!expect(']') || !expect(':'))
+			{
+				return Formula();
+			}
+
+			Formula op = parseUnary();
+			if (op.get() == 0)
+			{
+				return op;
+			}
+			for (auto v = variables.rbegin(); v != variables.rend(); ++v)
+			{
+				if (forall)
+				{
+					op = make_shared<Forall>(*v, op);
+				}
+				else
+				{
+					op = make_shared<Exists>(*v, op);
+				}
+			}
+			return op;
+		}
+		case TK_CHARACTER:
+		{
+			if (*_token.text != '(')
+			{
+				break;
+			}
+			nextToken();
+			Formula f = parseBinary(1);
+			if (f.get() == 0 || !expect(')'))
+			{
+				return Formula();
+			}
+			return f;
+		}
+		default:
+			break;
+	}
+	return parseAtomic();
+}
+
+Formula TptpParser::parseAtomic()
+{
+	if (_token.type == TK_DOLLAR)
+	{
+		string word(_token.text, _token.length);
+		if (word == "$true")
+		{
+			nextToken();
+			return make_shared<True>();
+		}
+		if (word == "$false")
+		{
+			nextToken();
+			return make_shared<False>();
+		}
+		fail("$true or $false");
+		return Formula();
+	}
+
+	switch (_token.type)
+	{
+		case TK_LOWER:
+		case TK_QUOTED:
+		case TK_UPPER:
+		case TK_NUMBER:
+		case TK_DISTINCT:
+			break;
+		default:
+			fail("a formula");
+			return Formula();
+	}
+
+	// Both an atom and the left side of an equality begin with a term,
+	// and only a functor can begin an atom
+	bool isFunctor = _token.type == TK_LOWER || _token.type == TK_QUOTED;
+	Term left = parseTerm();
+	if (left.get() == 0)
+	{
+		return Formula();
+	}
+
+	if (_token.type == TK_EQ || _token.type == TK_NEQ)
+	{
+		bool equality = _token.type == TK_EQ;
+		nextToken();
+		Term right = parseTerm();
+		if (right.get() == 0)
+		{
+			return Formula();
+		}
+		if (equality)
+		{
+			return make_shared<Equality>(left, right);
+		}
+		return make_shared<Disequality>(left, right);
+	}
+
+	if (!isFunctor)
+	{
+		fail("'=' or '!='");
+		return Formula();
+	}
+	const FunctionTerm * atom = (const FunctionTerm *)left.get();
+	return make_shared<Atom>(atom->getSymbol(), atom->getOperands());
+}
+
+Term TptpParser::parseTerm()
+{
+	switch (_token.type)
+	{
+		case TK_UPPER:
+		{
+			Variable v(_token.text, _token.length);
+			if (find(_variables.begin(), _variables.end(), v) == _variables.end())
+			{
+				_variables.push_back(v);
+			}
+			nextToken();
+			return make_shared<VariableTerm>(v);
+		}
+		case TK_NUMBER:
+		case TK_DISTINCT:
+		{
+			Term t = make_shared<FunctionTerm>(FunctionSymbol(_token.text, _token.length));
+			nextToken();
+			return t;
+		}
+		case TK_LOWER:
+		case TK_QUOTED:
+			break;
+		default:
+			fail("a term");
+			return Term();
+	}
+
+	FunctionSymbol symbol = getName();
+	vector<Term> operands;
+	nextToken();
+
+	if (isCharacter('('))
+	{
+		nextToken();
+		if (!parseTerms(operands) || !expect(')'))
+		{
+			return Term();
+		}
+	}
+	return make_shared<FunctionTerm>(symbol, move(operands));
+}
+
+bool TptpParser::parseTerms(vector<Term> & terms)
+{
+	while (true)
+	{
+		Term t = parseTerm();
+		if (t.get() == 0)
+		{
+			return false;
+		}
+		terms.push_back(t);
+
+		if (!isCharacter(','))
+		{
+			return true;
+		}
+		nextToken();
+	}
+}
+
+// END TptpParser
+// ----------------------------------------------------------------------------
+
+static string getDirectory(const string & path)
+{
+	size_t slash = path.find_last_of("/\\");
+	return slash == string::npos ? string() : path.substr(0, slash + 1);
+}
+
+static bool isAbsolute(const string & path)
+{
+	return (!path.empty() && (path[0] == '/' || path[0] == '\\')) || (path.size() > 1 && path[1] == ':');
+}
+
+static bool fileExists(const string & path)
+{
+	ifstream infile(path.c_str());
+	return infile.good();
+}
+
+/* Finds the file of an include statement. Returns an empty string if it
+cannot be found. */
+static string findInclude(const string & name, const string & includingFile, const string & includeDirectory)
+{
+	if (isAbsolute(name))
+	{
+		return name;
+	}
+
+	string path = getDirectory(includingFile) + name;
+	if (fileExists(path))
+	{
+		return path;
+	}
+	if (!includeDirectory.empty())
+	{
+		char last = includeDirectory[includeDirectory.size() - 1];
+		path = includeDirectory + (last == '/' || last == '\\' ? "" : "/") + name;
+		if (fileExists(path))
+		{
+			return path;
+		}
+	}
+	return string();
+}
+
+static bool readTptpFile(const string & path, const string & includeDirectory, const set<string> & selection,
+	vector<string> & openFiles, TptpProblem & problem, string & error)
+{
+	if (find(openFiles.begin(), openFiles.end(), path) != openFiles.end())
+	{
+		error = path + ": the file includes itself";
+		return false;
+	}
+
+	MappedFile file;
+	if (!file.open(path))
+	{
+		error = "cannot open " + path;
+		return false;
+	}
+	openFiles.push_back(path);
+
+	TptpParser parser(file.getData(), file.getSize());
+	TptpParser::Statement s;
+	string parseError;
+	bool ok = true;
+
+	while (ok && parser.parseNext(s, parseError))
+	{
+		if (s.type == TptpParser::ST_INCLUDE)
+		{
+			string included = findInclude(s.name, path, includeDirectory);
+			if (included.empty())
+			{
+				error = path + ": cannot find the included file " + s.name;
+				ok = false;
+			}
+			else
+			{
+				ok = readTptpFile(included, includeDirectory, s.selection.empty() ? selection : s.selection, openFiles, problem, error);
+			}
+		}
+		else if (selection.empty() || selection.count(s.name) > 0)
+		{
+			if (s.role == "conjecture")
+			{
+				problem.conjectures.push_back(s.formula);
+			}
+			else
+			{
+				problem.premises.push_back(s.formula);
+			}
+		}
+	}
+
+	if (ok && !parseError.empty())
+	{
+		error = path + ": " + parseError;
+		ok = false;
+	}
+	openFiles.pop_back();
+	return ok;
+}
+
+bool readTptpFile(const string & path, const string & includeDirectory, TptpProblem & problem, string & error)
+{
+	vector<string> openFiles;
+	problem = TptpProblem();
+	return readTptpFile(path, includeDirectory, set<string>(), openFiles, problem, error);
+}
+
+static Formula getConjunction(const vector<Formula> & formulas)
+{
+	Formula f;
+	for (const Formula & g : formulas)
+	{
+		f = f.get() == 0 ? g : make_shared<And>(f, g);
+	}
+	return f;
+}
+
+Formula getTptpConjecture(const TptpProblem & problem)
+{
+	return getConjunction(problem.conjectures);
+}
+
+Formula getTptpGoal(const TptpProblem & problem)
+{
+	Formula premises = getConjunction(problem.premises);
+	Formula conjectures = getConjunction(problem.conjectures);
+
+	if (conjectures.get() == 0)
+	{
+		// No formulas at all are satisfiable
+		if (premises.get() == 0)
+		{
+			return make_shared<False>();
+		}
+		return make_shared<Not>(premises);
+	}
+	if (premises.get() == 0)
+	{
+		return conjectures;
+	}
+	return make_shared<Imp>(premises, conjectures);
+}
+
+string getSzsStatus(const string & result, const TptpProblem & problem)
+{
+	bool conjectures = !problem.conjectures.empty();
+	if (result == "TAUTOLOGY")
+	{
+		return conjectures ? "Theorem" : "Unsatisfiable";
+	}
+	if (result == "NOT A TAUTOLOGY")
+	{
+		return conjectures ? "CounterSatisfiable" : "Satisfiable";
+	}
+	if (result == "UNKNOWN")
+	{
+		return "GaveUp";
+	}
+	return "Error";
+}
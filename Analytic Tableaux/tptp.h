@@ -0,0 +1,108 @@
+#ifndef _TPTP_H
+#define _TPTP_H
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include "fol.hpp"
+
+/* The formulas of a TPTP problem. The conjectures are the goals; all other
+formulas, including the negated conjectures of a CNF problem, are premises. */
+struct TptpProblem
+{
+	vector<Formula> premises;
+	vector<Formula> conjectures;
+};
+
+/* A parser for the fof and cnf statements of the TPTP syntax. Like the
+PrattParser it reads the statements one after another straight from a
+memory buffer. The formulas are built from the same classes; the TPTP
+connectives without their own class are rewritten (A <= B as B => A, A <~> B
+as ~(A <=> B), A ~| B as ~(A | B) and A ~& B as ~(A & B)), and the variables
+of a clause are bound by universal quantifiers. */
+class TptpParser
+{
+public:
+	enum StatementType { ST_FORMULA, ST_INCLUDE };
+
+	struct Statement
+	{
+		StatementType type;
+		// The name of the formula, or the file of the include
+		string name;
+		string role;
+		Formula formula;
+		// For an include, the names of the formulas to take from the file, or none for all
+		set<string> selection;
+	};
+private:
+	enum TokenType
+	{
+		TK_END, TK_LOWER, TK_UPPER, TK_DOLLAR, TK_QUOTED, TK_DISTINCT, TK_NUMBER,
+		TK_NOT, TK_AND, TK_OR, TK_IMP, TK_REVIMP, TK_IFF, TK_XOR, TK_NOR, TK_NAND,
+		TK_EQ, TK_NEQ, TK_FORALL, TK_EXISTS, TK_CHARACTER
+	};
+
+	struct Token
+	{
+		TokenType type;
+		const char * text;
+		size_t length;
+	};
+
+	const char * _buffer;
+	size_t _length;
+	size_t _position;
+	Token _token;
+	string _error;
+	// The variables of the current clause, in the order they appear
+	vector<Variable> _variables;
+
+	bool skipComment();
+	void nextToken();
+	bool isCharacter(char c) const;
+	bool expect(char c);
+	void fail(const string & expected);
+	string getName() const;
+
+	bool parseName(string & name);
+	bool parseAnnotations();
+	bool parseInclude(Statement & s);
+	static int getPrecedence(TokenType type);
+	Formula parseBinary(int minPrecedence);
+	Formula parseUnary();
+	Formula parseAtomic();
+	Term parseTerm();
+	bool parseTerms(vector<Term> & terms);
+public:
+	TptpParser(const char * buffer, size_t length);
+
+	/* Parses the next statement with its '.'. Returns false at the end of
+	the buffer, or if the statement is not correct; then the error is set. */
+	bool parseNext(Statement & s, string & error);
+};
+
+/* Reads the problem from a TPTP file. The files of the include statements
+are looked up first next to the file that includes them and then in the
+include directory, as the TPTP library expects them under its root. The
+files are mapped into memory and parsed in place. Returns false and sets
+the error if a file cannot be read or is not correct. */
+bool readTptpFile(const string & path, const string & includeDirectory, TptpProblem & problem, string & error);
+
+/* Gives the conjunction of the conjectures, or an empty formula if there
+are none, to be proved from the premises. */
+Formula getTptpConjecture(const TptpProblem & problem);
+
+/* Gives the formula that is a tautology exactly when the conjectures follow
+from the premises. A problem without conjectures gives the negation of its
+premises, which is a tautology when they are unsatisfiable. */
+Formula getTptpGoal(const TptpProblem & problem);
+
+/* Gives the SZS status of a TPTP problem for the result of its goal. NOT A
+TAUTOLOGY is taken to mean that the goal has a counter-model, so no engine may
+give it for a problem whose equalities it does not interpret; UNKNOWN is
+GaveUp. */
+string getSzsStatus(const string & result, const TptpProblem & problem);
+
+#endif // _TPTP_H
@@ -0,0 +1,262 @@
+#include "stdafx.h"
+#include "unification.h"
+
+// Follows the bindings of a variable until an unbound variable or a function term is reached
+static Term resolveBinding(const Term & t, const Substitution & s)
+{
+	Term resolved = t;
+	while (resolved->getType() == BaseTerm::TT_VARIABLE)
+	{
+		Substitution::const_iterator iter = s.find(((VariableTerm *)resolved.get())->getVariable());
+		if (iter == s.cend())
+		{
+			break;
+		}
+		resolved = iter->second;
+	}
+
+	return resolved;
+}
+
+static bool occursIn(const Variable & v, const Term & t, const Substitution & s)
+{
+	Term resolved = resolveBinding(t, s);
+
+	if (resolved->getType() == BaseTerm::TT_VARIABLE)
+	{
+		return ((VariableTerm *)resolved.get())->getVariable() == v;
+	}
+
+	const vector<Term> & ops = ((FunctionTerm *)resolved.get())->getOperands();
+	for (unsigned i = 0; i < ops.size(); ++i)
+	{
+		if (occursIn(v, ops[i], s))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+Term applySubstitution(const Term & t, const Substitution & s)
+{
+	Term resolved = resolveBinding(t, s);
+
+	if (resolved->getType() == BaseTerm::TT_VARIABLE)
+	{
+		return resolved;
+	}
+
+	FunctionTerm * pFunction = (FunctionTerm *)resolved.get();
+	const vector<Term> & ops = pFunction->getOperands();
+	if (ops.empty())
+	{
+		return resolved;
+	}
+
+	vector<Term> substOps;
+	for (unsigned i = 0; i < ops.size(); ++i)
+	{
+		substOps.push_back(applySubstitution(ops[i], s));
+	}
+
+	return make_shared<FunctionTerm>(pFunction->getSymbol(), substOps);
+}
+
+Formula applySubstitution(const Formula & atom, const Substitution & s)
+{
+	if (atom->getType() != BaseFormula::T_ATOM || s.empty())
+	{
+		return atom;
+	}
+
+	Atom * pAtom = (Atom *)atom.get();
+	const vector<Term> & ops = pAtom->getOperands();
+
+	vector<Term> substOps;
+	for (unsigned i = 0; i < ops.size(); ++i)
+	{
+		substOps.push_back(applySubstitution(ops[i], s));
+	}
+
+	return make_shared<Atom>(pAtom->getSymbol(), substOps);
+}
+
+Term applyRenaming(const Term & t, const Substitution & s)
+{
+	if (t->getType() == BaseTerm::TT_VARIABLE)
+	{
+		Substitution::const_iterator iter = s.find(((VariableTerm *)t.get())->getVariable());
+		return iter != s.cend() ? iter->second : t;
+	}
+
+	FunctionTerm * pFunction = (FunctionTerm *)t.get();
+	const vector<Term> & ops = pFunction->getOperands();
+	if (ops.empty())
+	{
+		return t;
+	}
+
+	vector<Term> renamedOps;
+	for (unsigned i = 0; i < ops.size(); ++i)
+	{
+		renamedOps.push_back(applyRenaming(ops[i], s));
+	}
+
+	return make_shared<FunctionTerm>(pFunction->getSymbol(), renamedOps);
+}
+
+Formula applyRenaming(const Formula & atom, const Substitution & s)
+{
+	if (atom->getType() != BaseFormula::T_ATOM || s.empty())
+	{
+		return atom;
+	}
+
+	Atom * pAtom = (Atom *)atom.get();
+	const vector<Term> & ops = pAtom->getOperands();
+
+	vector<Term> renamedOps;
+	for (unsigned i = 0; i < ops.size(); ++i)
+	{
+		renamedOps.push_back(applyRenaming(ops[i], s));
+	}
+
+	return make_shared<Atom>(pAtom->getSymbol(), renamedOps);
+}
+
+bool unify(const Term & t1, const Term & t2, Substitution & s)
+{
+	Term r1 = resolveBinding(t1, s);
+	Term r2 = resolveBinding(t2, s);
+
+	if (r1->getType() == BaseTerm::TT_VARIABLE)
+	{
+		const Variable & v = ((VariableTerm *)r1.get())->getVariable();
+
+		// Binding a variable to itself is a no-op
+		if (r2->getType() == BaseTerm::TT_VARIABLE && ((VariableTerm *)r2.get())->getVariable() == v)
+		{
+			return true;
+		}
+
+		if (occursIn(v, r2, s))
+		{
+			return false;
+		}
+
+		s[v] = r2;
+		return true;
+	}
+
+	if (r2->getType() == BaseTerm::TT_VARIABLE)
+	{
+		return unify(r2, r1, s);
+	}
+
+	FunctionTerm * f1 = (FunctionTerm *)r1.get();
+	FunctionTerm * f2 = (FunctionTerm *)r2.get();
+
+	if (f1->getSymbol() != f2->getSymbol() || f1->getOperands().size() != f2->getOperands().size())
+	{
+		return false;
+	}
+
+	for (unsigned i = 0; i < f1->getOperands().size(); ++i)
+	{
+		if (!unify(f1->getOperands()[i], f2->getOperands()[i], s))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool unifyAtoms(const Formula & a1, const Formula & a2, Substitution & s)
+{
+	if (a1->getType() != BaseFormula::T_ATOM || a2->getType() != BaseFormula::T_ATOM)
+	{
+		return false;
+	}
+
+	Atom * p1 = (Atom *)a1.get();
+	Atom * p2 = (Atom *)a2.get();
+
+	if (p1->getSymbol() != p2->getSymbol() || p1->getOperands().size() != p2->getOperands().size())
+	{
+		return false;
+	}
+
+	for (unsigned i = 0; i < p1->getOperands().size(); ++i)
+	{
+		if (!unify(p1->getOperands()[i], p2->getOperands()[i], s))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool match(const Term & pattern, const Term & target, Substitution & s)
+{
+	if (pattern->getType() == BaseTerm::TT_VARIABLE)
+	{
+		// The variables of the target are never bound, so the bindings are not followed
+		const Variable & v = ((VariableTerm *)pattern.get())->getVariable();
+		Substitution::const_iterator iter = s.find(v);
+		if (iter != s.cend())
+		{
+			return iter->second->equalTo(target);
+		}
+
+		s[v] = target;
+		return true;
+	}
+
+	if (target->getType() != BaseTerm::TT_FUNCTION)
+	{
+		return false;
+	}
+
+	FunctionTerm * fp = (FunctionTerm *)pattern.get();
+	FunctionTerm * ft = (FunctionTerm *)target.get();
+
+	if (fp->getSymbol() != ft->getSymbol() || fp->getOperands().size() != ft->getOperands().size())
+	{
+		return false;
+	}
+
+	for (unsigned i = 0; i < fp->getOperands().size(); ++i)
+	{
+		if (!match(fp->getOperands()[i], ft->getOperands()[i], s))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool matchAtoms(const Formula & pattern, const Formula & target, Substitution & s)
+{
+	Atom * pp = (Atom *)pattern.get();
+	Atom * pt = (Atom *)target.get();
+
+	if (pp->getSymbol() != pt->getSymbol() || pp->getOperands().size() != pt->getOperands().size())
+	{
+		return false;
+	}
+
+	for (unsigned i = 0; i < pp->getOperands().size(); ++i)
+	{
+		if (!match(pp->getOperands()[i], pt->getOperands()[i], s))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
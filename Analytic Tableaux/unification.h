@@ -0,0 +1,29 @@
+#ifndef _UNIFICATION_H
+#define _UNIFICATION_H
+
+#include <map>
+
+#include "fol.hpp"
+
+typedef map<Variable, Term> Substitution;
+
+// Applies the substitution to the term, following the bindings of the bound variables
+Term applySubstitution(const Term & t, const Substitution & s);
+// Applies the substitution to the operands of an atom
+Formula applySubstitution(const Formula & atom, const Substitution & s);
+
+// Replaces the variables of the term simultaneously, without following the bindings
+Term applyRenaming(const Term & t, const Substitution & s);
+// Replaces the variables in the operands of an atom simultaneously
+Formula applyRenaming(const Formula & atom, const Substitution & s);
+
+// Extends the substitution to a most general unifier of the two terms, if there is one
+bool unify(const Term & t1, const Term & t2, Substitution & s);
+// Extends the substitution to a most general unifier of the two atoms, if there is one
+bool unifyAtoms(const Formula & a1, const Formula & a2, Substitution & s);
+
+// Extends the substitution so that it maps the pattern onto the target, if possible
+bool match(const Term & pattern, const Term & target, Substitution & s);
+bool matchAtoms(const Formula & pattern, const Formula & target, Substitution & s);
+
+#endif // _UNIFICATION_H